@@ -1,69 +1,125 @@
 #include "FMEngine.h"
+#include "../Utils/Logger.h"
+#include "../Utils/Stats.h"
 #include <algorithm>
 #include <random>
 #include <chrono>
-#include <iostream>
-#include <unordered_set>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
 
 namespace fm {
 
-FMEngine::FMEngine(Netlist& netlist, double balanceFactor)
-    : netlist_(netlist)
-    , partitionState_(netlist.getCells().size(), balanceFactor)
-    , gainBucket_(getMaxPossibleDegree()) {
-    std::cout << "Initializing FMEngine..." << std::endl;
+namespace {
+
+// Smallest per-task range for the parallel initialization loops
+constexpr int MIN_CHUNK = 4096;
+
+} // namespace
+
+FMEngine::FMEngine(const Hypergraph& graph, double balanceFactor, const FMOptions& options)
+    : graph_(graph)
+    , options_(options)
+    , partitionState_(graph.getTotalCellWeight(), balanceFactor)
+    , gainBucket_(getMaxPossibleGain()) {
+    FM_DEBUG("Initializing FMEngine...");
+    auto initStart = std::chrono::steady_clock::now();
+    gainBucket_.setTieBreak(options_.tieBreak, options_.seed);
     initializePartitions();
-    std::cout << "FMEngine initialized." << std::endl;
+    stats_.initSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - initStart).count();
+    FM_DEBUG("FMEngine initialized.");
 }
 
-void FMEngine::run() {
-    std::cout << "Starting F-M passes..." << std::endl;
+FMEngine::FMEngine(const Hypergraph& graph, double balanceFactor,
+                   const std::vector<int>& initialPartition, const FMOptions& options)
+    : graph_(graph)
+    , options_(options)
+    , partitionState_(graph.getTotalCellWeight(), balanceFactor)
+    , gainBucket_(getMaxPossibleGain()) {
+    FM_DEBUG("Initializing FMEngine from given partition...");
+    auto initStart = std::chrono::steady_clock::now();
+    gainBucket_.setTieBreak(options_.tieBreak, options_.seed);
+    if (static_cast<int>(initialPartition.size()) != graph_.getNumCells()) {
+        throw std::invalid_argument("Initial partition has " + std::to_string(initialPartition.size()) +
+                                    " entries for " + std::to_string(graph_.getNumCells()) + " cells");
+    }
+    for (int side : initialPartition) {
+        if (side != 0 && side != 1) {
+            throw std::invalid_argument("Initial partition assigns a cell to side " + std::to_string(side));
+        }
+    }
+    cellPartition_ = initialPartition;
+    initializeState();
+    stats_.initSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - initStart).count();
+    FM_DEBUG("FMEngine initialized.");
+}
+
+const FMStats& FMEngine::run() {
+    FM_DEBUG("Starting F-M passes...");
+    const StopPolicy& policy = options_.stop;
     bool improved;
     int passCount = 0;
-    const int MAX_PASSES = 50;  // Limit maximum number of passes
     int lastCutSize = partitionState_.getCurrentCutSize();
     int noImprovementCount = 0;
-    const int MAX_NO_IMPROVEMENT = 3;  // Stop if no improvement for this many passes
 
-    std::cout << "Initial state - Cut size: " << lastCutSize 
-              << ", Partition sizes: [" << partitionState_.getPartitionSize(0) 
-              << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl;
+    FM_INFO("Initial state - Cut size: ", lastCutSize, ", Partition sizes: [",
+            partitionState_.getPartitionSize(0), ", ", partitionState_.getPartitionSize(1), "]");
+    stats_.passes.clear();
+    stats_.stopReason = StopReason::CONVERGED;
 
     do {
+        // An interrupted run keeps the partition of the last completed pass
+        if (shouldInterrupt()) {
+            stats_.stopReason = interruptReason();
+            FM_INFO("Stopping before pass ", passCount + 1, ": ", toString(stats_.stopReason));
+            break;
+        }
+
         passCount++;
-        std::cout << "\nStarting pass " << passCount << " of maximum " << MAX_PASSES << std::endl;
+        FM_DEBUG("\nStarting pass ", passCount, " of maximum ", policy.maxPasses);
         
         // Verify state before pass
         if (!partitionState_.isBalanced(partitionState_.getPartitionSize(0), 
                                       partitionState_.getPartitionSize(1))) {
-            std::cerr << "Error: Unbalanced partitions before pass " << passCount << std::endl;
+            FM_ERROR("Error: Unbalanced partitions before pass ", passCount);
+            stats_.stopReason = StopReason::ERROR;
             break;
         }
 
         // Run the pass, passing the current pass number
+        auto passStart = std::chrono::steady_clock::now();
         improved = runPass(passCount);
         int currentCutSize = partitionState_.getCurrentCutSize();
+        double passSeconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - passStart).count();
+        stats_.passes.back().seconds = passSeconds;
         
-        std::cout << "Pass " << passCount << " completed. "
-                  << "Previous cut size: " << lastCutSize 
-                  << ", Current cut size: " << currentCutSize 
-                  << ", Improved: " << (improved ? "yes" : "no") << std::endl;
+        FM_INFO("Pass ", passCount, " completed. ", "Previous cut size: ", lastCutSize,
+                ", Current cut size: ", currentCutSize, ", Improved: ", (improved ? "yes" : "no"));
         
+        // The pass was cut short (or the time is up); its best prefix is kept
+        if (shouldInterrupt()) {
+            stats_.stopReason = interruptReason();
+            FM_INFO("Stopping after pass ", passCount, ": ", toString(stats_.stopReason));
+            break;
+        }
+
         // Check for actual improvement in cut size
-        if (currentCutSize >= lastCutSize) {
+        int improvement = lastCutSize - currentCutSize;
+        if (improvement <= 0) {
             noImprovementCount++;
-            std::cout << "No cut size improvement for " << noImprovementCount 
-                      << " passes" << std::endl;
+            FM_DEBUG("No cut size improvement for ", noImprovementCount, " passes");
             
-            if (noImprovementCount >= MAX_NO_IMPROVEMENT) {
-                std::cout << "Stopping due to lack of improvement for " 
-                          << MAX_NO_IMPROVEMENT << " passes" << std::endl;
+            if (noImprovementCount >= policy.maxPassesWithoutImprovement) {
+                FM_INFO("Stopping due to lack of improvement for ", noImprovementCount, " passes");
+                stats_.stopReason = StopReason::NO_IMPROVEMENT;
                 break;
             }
         } else {
             noImprovementCount = 0;
-            std::cout << "Cut size improved by " << (lastCutSize - currentCutSize) 
-                      << std::endl;
+            FM_DEBUG("Cut size improved by ", improvement);
         }
         
         lastCutSize = currentCutSize;
@@ -71,158 +127,195 @@ void FMEngine::run() {
         // Verify state after pass
         if (!partitionState_.isBalanced(partitionState_.getPartitionSize(0), 
                                       partitionState_.getPartitionSize(1))) {
-            std::cerr << "Error: Unbalanced partitions after pass " << passCount << std::endl;
+            FM_ERROR("Error: Unbalanced partitions after pass ", passCount);
+            stats_.stopReason = StopReason::ERROR;
             break;
         }
 
         // Check for maximum passes
-        if (passCount >= MAX_PASSES) {
-            std::cout << "Stopping due to maximum pass limit (" << MAX_PASSES 
-                      << ") reached" << std::endl;
+        if (passCount >= policy.maxPasses) {
+            FM_INFO("Stopping due to maximum pass limit (", policy.maxPasses, ") reached");
+            stats_.stopReason = StopReason::MAX_PASSES;
+            break;
+        }
+
+        // Another pass is not worth it if this one gained too little per second
+        if (improved && policy.minImprovementRate > 0.0 && passSeconds > 0.0 &&
+            improvement / passSeconds < policy.minImprovementRate) {
+            FM_INFO("Stopping due to slow progress (", improvement / passSeconds,
+                    " cut/s, minimum ", policy.minImprovementRate, ")");
+            stats_.stopReason = StopReason::SLOW_PROGRESS;
             break;
         }
 
         // Verify all cells are unlocked between passes
         bool allUnlocked = true;
-        for (const auto& cell : netlist_.getCells()) {
-            if (cell.locked) {
-                std::cerr << "Error: Cell " << cell.name << " still locked after pass" << std::endl;
+        for (int cellId = 0; cellId < graph_.getNumCells(); cellId++) {
+            if (cellLocked_[cellId]) {
+                FM_ERROR("Error: Cell ", cellLabel(cellId), " still locked after pass");
                 allUnlocked = false;
             }
         }
         if (!allUnlocked) {
-            std::cerr << "Error: Some cells still locked between passes" << std::endl;
+            FM_ERROR("Error: Some cells still locked between passes");
+            stats_.stopReason = StopReason::ERROR;
             break;
         }
 
     } while (improved);
 
-    std::cout << "F-M passes completed after " << passCount << " passes." << std::endl;
-    std::cout << "Final state - Cut size: " << partitionState_.getCurrentCutSize() 
-              << ", Partition sizes: [" << partitionState_.getPartitionSize(0) 
-              << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl;
+    FM_INFO("F-M passes completed after ", passCount, " passes (", toString(stats_.stopReason), ").");
+    FM_INFO("Final state - Cut size: ", partitionState_.getCurrentCutSize(), ", Partition sizes: [",
+            partitionState_.getPartitionSize(0), ", ", partitionState_.getPartitionSize(1), "]");
+    return stats_;
+}
+
+bool FMEngine::shouldInterrupt() const {
+    return stopRequested_.load(std::memory_order_relaxed) ||
+           (options_.stop.hasDeadline() && StopPolicy::Clock::now() >= options_.stop.deadline);
+}
+
+StopReason FMEngine::interruptReason() const {
+    return stopRequested_.load(std::memory_order_relaxed) ? StopReason::STOP_REQUESTED
+                                                          : StopReason::DEADLINE;
 }
 
 void FMEngine::initializePartitions() {
-    std::cout << "Creating initial partition..." << std::endl;
-    // Get references to cells and nets
-    std::vector<Cell>& cells = const_cast<std::vector<Cell>&>(netlist_.getCells());
-    std::vector<Net>& nets = netlist_.getNets(); // Use the getter that returns a non-const reference
-    
-    // Validate cells vector
-    if (cells.empty()) {
-        std::cerr << "Error: No cells found in netlist" << std::endl;
+    FM_DEBUG("Creating initial partition...");
+    int totalCells = graph_.getNumCells();
+
+    // Validate cells
+    if (totalCells <= 0) {
+        FM_ERROR("Error: No cells found in netlist");
         return;
     }
 
-    // Reset all cell partitions (but preserve connectivity)
-    for (auto& cell : cells) {
-        cell.partition = -1; // Mark as unassigned
-        cell.gain = 0;       // Reset gain
-        cell.locked = false; // Make sure cell is unlocked
-    }
-    
-    // Reset net partition counts 
-    for (auto& net : nets) {
-        net.partitionCount[0] = 0;
-        net.partitionCount[1] = 0;
+    // Create balanced initial partition with the configured strategy
+    auto splitStart = std::chrono::steady_clock::now();
+    cellPartition_ = makeInitialSplit(graph_, options_.initialSplit, options_.seed);
+    stats_.splitSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - splitStart).count();
+
+    FM_DEBUG("Initial partition created.");
+    initializeState();
+    FM_INFO("Initial partition (", toString(options_.initialSplit), "): cut size ",
+            stats_.initialCutSize, " in ", stats_.splitSeconds * 1000.0, " ms");
+}
+
+void FMEngine::initializeState() {
+    int totalCells = graph_.getNumCells();
+    int totalNets = graph_.getNumNets();
+
+    // Every step below is independent per cell or per net; with more than
+    // one thread they run in chunks on a pool that lives for this call only
+    if (options_.threads != 1) {
+        pool_ = std::make_unique<ThreadPool>(options_.threads);
     }
-    
-    // Create balanced initial partition
-    int totalCells = cells.size();
-    int targetSize = totalCells / 2;
-    int partition1Count = 0;
-    
-    // Assign cells to partitions sequentially for deterministic results
-    for (auto& cell : cells) {
-        // Assign to partition 0 if we haven't reached target size
-        if (partition1Count < targetSize) {
-            cell.partition = 0;
-            partition1Count++;
-        } else {
-            cell.partition = 1;
+    ThreadPool* pool = pool_.get();
+
+    // Reset all cell state (connectivity lives in the shared hypergraph)
+    cellGain_.assign(totalCells, 0);       // Reset gain
+    cellLocked_.assign(totalCells, 0);     // Make sure cells are unlocked
+    movedCells_.resize(totalCells);
+
+    // Nets above the pin threshold are almost always cut, and moving any of
+    // their cells would touch every pin; they still count in the cut but
+    // contribute nothing to gains
+    netGainWeight_.resize(totalNets);
+    long long largeNets = parallelSum(pool, totalNets, MIN_CHUNK, [this](int begin, int end) {
+        long long large = 0;
+        for (int netId = begin; netId < end; netId++) {
+            bool isLarge = options_.largeNetThreshold > 0 &&
+                           graph_.getNetSize(netId) > options_.largeNetThreshold;
+            netGainWeight_[netId] = isLarge ? 0 : graph_.getNetWeight(netId);
+            large += isLarge ? 1 : 0;
         }
-        
-        // Update partition counts for all nets this cell belongs to
-        // Iterate over net IDs now
-        for (int netId : cell.netIds) {
-            Net* net = netlist_.getNetById(netId); // Fetch net by ID
-            if (net) {
-                net->partitionCount[cell.partition]++;
-            } else {
-                 std::cerr << "Warning: Net with ID " << netId << " not found during init for cell " << cell.name << std::endl;
+        return large;
+    });
+    if (largeNets > 0) {
+        FM_DEBUG("Excluding ", largeNets, " nets with more than ", options_.largeNetThreshold,
+                 " pins from gains");
+    }
+
+    // Rebuild net partition counts from the assignment. Counting per net
+    // over its pins (rather than per cell over its nets) gives every chunk
+    // its own nets to write.
+    netPartitionCount_.resize(totalNets);
+    parallelFor(pool, totalNets, MIN_CHUNK, [this](int begin, int end) {
+        for (int netId = begin; netId < end; netId++) {
+            std::array<int, 2> count = {0, 0};
+            for (int cellId : graph_.getNetPins(netId)) {
+                count[cellPartition_[cellId]]++;
             }
+            netPartitionCount_[netId] = count;
         }
-    }
-    
-    std::cout << "Initial partition created." << std::endl;
-    std::cout << "Partition sizes: [" << partition1Count << ", " 
-              << (totalCells - partition1Count) << "]" << std::endl;
-    
+    });
+
+    // Side weights: side 1 is the total minus side 0
+    int partitionSize[2];
+    partitionSize[1] = static_cast<int>(parallelSum(pool, totalCells, MIN_CHUNK,
+                                                    [this](int begin, int end) {
+        long long weight = 0;
+        for (int cellId = begin; cellId < end; cellId++) {
+            weight += cellPartition_[cellId] == 1 ? graph_.getCellWeight(cellId) : 0;
+        }
+        return weight;
+    }));
+    partitionSize[0] = graph_.getTotalCellWeight() - partitionSize[1];
+
+    FM_DEBUG("Partition sizes: [", partitionSize[0], ", ", partitionSize[1], "]");
+
     // Update partition state
-    partitionState_.updatePartitionSize(0, partition1Count);
-    partitionState_.updatePartitionSize(1, totalCells - partition1Count);
-    
+    partitionState_.updatePartitionSize(0, partitionSize[0]);
+    partitionState_.updatePartitionSize(1, partitionSize[1]);
+
     // Calculate initial cut size
-    int initialCutSize = 0;
-    // Use the nets vector directly
-    for (const auto& net : nets) { 
-        // A net is cut if it has cells in both partitions
-        if (net.partitionCount[0] > 0 && net.partitionCount[1] > 0) {
-            initialCutSize++;
-        }
-    }
-    
+    int initialCutSize = calculateCurrentCutSize();
+
     // Set the initial cut size
     partitionState_.updateCutSize(initialCutSize);
-    std::cout << "Initial cut size: " << initialCutSize << std::endl;
-    
+    stats_.initialCutSize = initialCutSize;
+    FM_DEBUG("Initial cut size: ", initialCutSize);
+
     // Calculate initial cell gains
     calculateInitialGains();
-    
-    // Initialize the gain bucket with all cells
-    gainBucket_.initialize(cells);
-    
-    std::cout << "FMEngine initialization completed." << std::endl;
+
+    // Build the gain bucket from the precomputed gains
+    gainBucket_.initialize(cellPartition_, cellGain_, cellLocked_);
+
+    pool_.reset();
+    FM_DEBUG("FMEngine initialization completed.");
 }
 
 bool FMEngine::runPass(int passCount) {
     // std::cout << "Starting runPass..." << std::endl; // Reduced logging
-    const std::vector<Cell>& cells = netlist_.getCells();
-    int numCells = cells.size();
+    int numCells = graph_.getNumCells();
     moveHistory_.clear();
     int initialCutSize = partitionState_.getCurrentCutSize(); // Store initial cutsize
 
     // std::cout << "Initial state - Cut size: " << initialCutSize \n    //           << ", Partition sizes: [" << partitionState_.getPartitionSize(0) \n    //           << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl; // Reduced logging
 
-    // Unlock all cells and verify gain bucket state
-    // std::cout << "Unlocking cells and verifying gain bucket..." << std::endl; // Reduced logging
-    for (auto& cell : const_cast<std::vector<Cell>&>(cells)) {
-        cell.locked = false;
-        // Verify cell's gain matches its position in gain bucket
-        if (cell.bucketNodePtr && cell.bucketNodePtr->cellPtr != &cell) {
-            // This check might still be useful, but let's silence it for perf
-            // std::cerr << "Error: Cell " << cell.name << " has inconsistent bucket node pointer" << std::endl;
-            gainBucket_.removeCell(&cell);
-            gainBucket_.addCell(&cell);
-        }
-    }
+    // All cells are unlocked and bucketed: the previous pass (or
+    // initialization) left them that way
 
     int bestCutSize = partitionState_.getCurrentCutSize();
     int bestMoveIndex = -1;
     int movesWithoutImprovement = 0;
 
-    // --- Adaptive Threshold Calculation --- START
-    const int START_THRESHOLD = 2000;
-    const int MIN_THRESHOLD = 500;
-    const int DECREASE_PER_PASS = 100;
-    int adaptiveThreshold = std::max(MIN_THRESHOLD, START_THRESHOLD - (passCount - 1) * DECREASE_PER_PASS);
-    // const int MAX_MOVES_WITHOUT_IMPROVEMENT = 1000; // Limit unproductive moves - OLD FIXED
-    const int MAX_MOVES_WITHOUT_IMPROVEMENT = adaptiveThreshold; // NEW ADAPTIVE
-    // --- Adaptive Threshold Calculation --- END
+    // Adaptive threshold: long unproductive tails are allowed early on,
+    // when the partition is still far from a local minimum
+    const int MAX_MOVES_WITHOUT_IMPROVEMENT = options_.stop.threshold(passCount);
 
     // Track moved cells to prevent infinite loops
-    std::unordered_set<Cell*> movedCells;
+    movedCells_.clear();
+
+    // Counter baselines; the bucket and neighbor counts are running totals
+    PassSummary summary;
+    summary.threshold = MAX_MOVES_WITHOUT_IMPROVEMENT;
+    long long bucketUpdatesBefore = gainBucket_.getUpdateCount();
+    long long bucketScansBefore = gainBucket_.getScanCount();
+    long long neighborVisitsBefore = neighborVisits_;
+    auto moveStart = std::chrono::steady_clock::now();
 
     // std::cout << "Starting moves loop..." << std::endl; // Reduced logging
     // Make moves until we can't improve or reach all cells
@@ -230,46 +323,51 @@ bool FMEngine::runPass(int passCount) {
         // std::cout << "\nMove " << i + 1 << " of " << numCells << std::endl; // Reduced logging
         // std::cout << "Current cut size: " << partitionState_.getCurrentCutSize() << std::endl; // Reduced logging
 
+        // Deadline / stop request; the moves so far are rolled back to the
+        // best prefix below, as at the end of any pass
+        if ((i & 63) == 0 && shouldInterrupt()) {
+            FM_DEBUG("Pass ", passCount, " interrupted after ", i, " moves");
+            break;
+        }
+
         // Get highest gain cell that maintains balance
-        Cell* cell = gainBucket_.getBestFeasibleCell(partitionState_);
-        if (!cell) {
+        int cellId = gainBucket_.getBestFeasibleCell(partitionState_, graph_.getCellWeights());
+        if (cellId < 0) {
             // std::cout << "No feasible cell found, breaking..." << std::endl; // Reduced logging
             break;
         }
 
         // Check if cell was already moved
-        if (movedCells.find(cell) != movedCells.end()) {
-            // std::cout << "Cell " << cell->name << " was already moved in this pass, breaking..." << std::endl; // Reduced logging
+        if (movedCells_.contains(cellId)) {
+            // std::cout << "Cell " << cellLabel(cellId) << " was already moved in this pass, breaking..." << std::endl; // Reduced logging
             break;
         }
 
         // Validate selected cell
-        if (cell->locked) {
-            std::cerr << "Error: Selected locked cell " << cell->name << std::endl; // Keep critical errors
+        if (cellLocked_[cellId]) {
+            FM_ERROR("Error: Selected locked cell ", cellLabel(cellId)); // Keep critical errors
             break;
         }
 
-        // std::cout << "Selected cell " << cell->name << " with gain " << cell->gain \n        //           << " from partition " << cell->partition << std::endl; // Reduced logging
-
         // Record move
         Move move;
-        move.cell = cell;
-        move.fromPartition = cell->partition;
-        move.toPartition = 1 - cell->partition;
-        move.gain = cell->gain;
+        move.cellId = cellId;
+        move.fromPartition = cellPartition_[cellId];
+        move.toPartition = 1 - cellPartition_[cellId];
+        move.gain = cellGain_[cellId];
 
         // Verify move legality
-        if (!isMoveLegal(cell, move.toPartition)) {
-            std::cerr << "Error: Illegal move detected for cell " << cell->name << std::endl; // Keep critical errors
+        if (!isMoveLegal(cellId, move.toPartition)) {
+            FM_ERROR("Error: Illegal move detected for cell ", cellLabel(cellId)); // Keep critical errors
             break;
         }
 
         // Apply move
         // std::cout << "Applying move..." << std::endl; // Reduced logging
-        applyMove(cell, move.toPartition);
+        applyMove(cellId, move.toPartition);
         move.resultingCutSize = partitionState_.getCurrentCutSize();
         moveHistory_.push_back(move);
-        movedCells.insert(cell);  // Track that this cell was moved
+        movedCells_.insert(cellId);  // Track that this cell was moved
 
         // std::cout << "Move completed. New cut size: " << move.resultingCutSize \n        //           << ", Partition sizes: [" << partitionState_.getPartitionSize(0) \n        //           << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl; // Reduced logging
 
@@ -287,7 +385,7 @@ bool FMEngine::runPass(int passCount) {
         // Verify partition balance after move
         if (!partitionState_.isBalanced(partitionState_.getPartitionSize(0),
                                       partitionState_.getPartitionSize(1))) {
-            std::cerr << "Error: Unbalanced partitions after move" << std::endl; // Keep critical errors
+            FM_ERROR("Error: Unbalanced partitions after move"); // Keep critical errors
             break;
         }
 
@@ -295,9 +393,9 @@ bool FMEngine::runPass(int passCount) {
         // This check might be slow, consider removing if confident
         /*
         bool foundLockedCell = false;
-        for (const auto& c : cells) {
-            if (c.locked && c.bucketNodePtr != nullptr) {
-                std::cerr << "Error: Locked cell " << c.name << " found in gain bucket" << std::endl; // Keep critical errors
+        for (int c = 0; c < numCells; c++) {
+            if (cellLocked_[c] && gainBucket_.contains(c)) {
+                FM_ERROR("Error: Locked cell ", cellLabel(c), " found in gain bucket"); // Keep critical errors
                 foundLockedCell = true;
             }
         }
@@ -310,199 +408,175 @@ bool FMEngine::runPass(int passCount) {
     // std::cout << "\nMoves completed. Best move index: " << bestMoveIndex << std::endl; // Reduced logging
 
     // Revert moves based on the best state found
+    auto rollbackStart = std::chrono::steady_clock::now();
+    summary.moveSeconds = std::chrono::duration<double>(rollbackStart - moveStart).count();
+    summary.moves = static_cast<int>(moveHistory_.size());
     revertMovesToBestState(bestMoveIndex, initialCutSize); // Pass initial cutsize
+    summary.rollbackSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - rollbackStart).count();
+    summary.keptMoves = static_cast<int>(moveHistory_.size());
+    summary.revertedMoves = summary.moves - summary.keptMoves;
+    summary.cutSize = partitionState_.getCurrentCutSize();
+    summary.bucketUpdates = gainBucket_.getUpdateCount() - bucketUpdatesBefore;
+    summary.bucketScans = gainBucket_.getScanCount() - bucketScansBefore;
+    summary.neighborVisits = neighborVisits_ - neighborVisitsBefore;
+    stats_.passes.push_back(summary);
 
     // Return true if an improvement was potentially found and kept
     return bestMoveIndex >= 0 && bestCutSize < initialCutSize;
 }
 
 void FMEngine::calculateInitialGains() {
-    for (auto& cell : const_cast<std::vector<Cell>&>(netlist_.getCells())) {
-        cell.gain = calculateCellGain(&cell);
-    }
+    parallelFor(pool_.get(), graph_.getNumCells(), MIN_CHUNK, [this](int begin, int end) {
+        for (int cellId = begin; cellId < end; cellId++) {
+            cellGain_[cellId] = calculateCellGain(cellId);
+        }
+    });
 }
 
-int FMEngine::calculateCellGain(Cell* cell) const {
-    if (!cell) {
-        std::cerr << "calculateCellGain: Error - null cell pointer" << std::endl;
-        return 0;
-    }
-
+int FMEngine::calculateCellGain(int cellId) const {
     int gain = 0;
-    int fromPartition = cell->partition;
+    int fromPartition = cellPartition_[cellId];
     int toPartition = 1 - fromPartition;
 
-    // Iterate over net IDs
-    for (int netId : cell->netIds) {
-        const Net* net = netlist_.getNetById(netId); // Fetch net by ID (const version if possible, check Netlist)
-        if (!net) {
-            std::cerr << "Warning: Net with ID " << netId << " not found during gain calc for cell " << cell->name << std::endl;
-            continue; 
-        }
+    for (int netId : graph_.getCellNets(cellId)) {
+        int weight = netGainWeight_[netId];
 
         // Check net distribution
-        int fromCount = net->partitionCount[fromPartition];
-        int toCount = net->partitionCount[toPartition];
+        int fromCount = netPartitionCount_[netId][fromPartition];
+        int toCount = netPartitionCount_[netId][toPartition];
 
-        // If moving this cell makes the net uncut (FS=1, TE=0 -> FS=0, TE=1)
-        if (fromCount == 1 && toCount == 0) {
-            gain++;
+        // If moving this cell makes the net uncut (only cell on its side, FS)
+        if (fromCount == 1 && toCount > 0) {
+            gain += weight;
         }
-        // If moving this cell makes the net cut (FS=current, TE=0 -> FS=current-1, TE=1)
-        else if (toCount == 0) {
-            gain--;
+        // If moving this cell makes the net cut (net entirely on its side, TE)
+        else if (toCount == 0 && fromCount > 1) {
+            gain -= weight;
         }
     }
     return gain;
 }
 
-void FMEngine::updateGainsAfterMove(Cell* movedCell) {
-    if (!movedCell) {
-        std::cerr << "updateGainsAfterMove: Error - null cell pointer" << std::endl;
-        return;
-    }
-
-    // Track affected cells that need gain updates
-    std::unordered_set<Cell*> cellsToUpdate;
-    
-    // Process each net connected to the moved cell
-    for (int netId : movedCell->netIds) {
-        Net* net = netlist_.getNetById(netId); // Fetch net by ID
-        if (!net) continue;
-        
-        // Get all cell IDs on this net
-        for (int neighborCellId : net->cellIds) {
-            Cell* neighborCell = netlist_.getCellById(neighborCellId); // Fetch neighbor cell
-            if (!neighborCell) continue;
-
-            // Skip the moved cell and locked cells
-            if (neighborCell == movedCell || neighborCell->locked) continue;
-            
-            // Add to update list
-            cellsToUpdate.insert(neighborCell);
-        }
-    }
-    
-    // Update gains for all affected cells
-    for (Cell* cell : cellsToUpdate) {
-        int oldGain = cell->gain;
-        int newGain = calculateCellGain(cell);
-        
-        if (oldGain != newGain) {
-            gainBucket_.updateCellGain(cell, oldGain, newGain);
-        }
-    }
-}
-
 void FMEngine::revertMovesToBestState(int bestMoveIndex, int initialCutSize) {
     // Revert moves from end to best state (or all moves if bestMoveIndex < 0)
-    std::cout << "Reverting moves from index " << moveHistory_.size() - 1 << " down to " << bestMoveIndex + 1 << std::endl;
+    FM_DEBUG("Reverting moves from index ", moveHistory_.size() - 1, " down to ",
+             bestMoveIndex + 1);
     for (int i = moveHistory_.size() - 1; i > bestMoveIndex; i--) {
         const Move& move = moveHistory_[i];
-        std::cout << "  Reverting move " << i << " for cell " << move.cell->name << std::endl;
+        FM_TRACE("  Reverting move ", i, " for cell ", cellLabel(move.cellId));
         undoMove(move);
     }
-    std::cout << "Move reversion complete." << std::endl;
+    FM_DEBUG("Move reversion complete.");
     
     // Clear the rest of the move history (moves that were kept or reverted)
     if (bestMoveIndex + 1 < static_cast<int>(moveHistory_.size())) {
         moveHistory_.resize(bestMoveIndex + 1);
-    } else if (bestMoveIndex == -1) {
-        moveHistory_.clear(); // Cleared all moves
-        // Explicitly reset cutsize to the state before the pass began
-        partitionState_.setCurrentCutSize(initialCutSize);
-        // Debug: Immediately check the value after setting
-        std::cout << "Debug: Cut size immediately after reset: " << partitionState_.getCurrentCutSize() << std::endl; 
-        std::cout << "All moves reverted. Cut size reset to initial pass value: " << initialCutSize << std::endl;
+    }
+    if (bestMoveIndex == -1) {
+        FM_DEBUG("All moves reverted. Cut size back to initial pass value: ", initialCutSize);
     }
 
-    // Recalculate the cut size based on the current state after reverts
-    int finalCutSize = calculateCurrentCutSize();
-    partitionState_.setCurrentCutSize(finalCutSize);
-    std::cout << "Cut size recalculated after reverts: " << finalCutSize << std::endl;
-
-    // Recalculate all gains and rebuild bucket for consistency after reverting?
-    // Maybe not necessary if undoMove handles gains correctly. But could be a safeguard.
-    // Let's skip this for now and rely on undoMove.
-    
-     std::cout << "State after reversion - Cut size: " << partitionState_.getCurrentCutSize() 
-              << ", Partition sizes: [" << partitionState_.getPartitionSize(0) 
-              << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl;
-}
+    // Unlock the kept moves for the next pass. Their gains went stale while
+    // they were locked, so recompute them and file them back in the bucket.
+    for (const Move& move : moveHistory_) {
+        cellLocked_[move.cellId] = 0;
+        cellGain_[move.cellId] = calculateCellGain(move.cellId);
+        gainBucket_.addCell(move.cellId, cellPartition_[move.cellId], cellGain_[move.cellId]);
+    }
 
-void FMEngine::applyMove(Cell* cell, int toPartition) {
-    if (!cell) {
-        std::cerr << "applyMove: Error - null cell pointer" << std::endl;
-        return;
+#ifdef FM_DEBUG_CHECKS
+    // Full recompute of everything the incremental updates maintain
+    if (!verifyState()) {
+        FM_ERROR("Error: Incremental state diverged after reverting moves");
     }
+#endif
 
-    int fromPartition = cell->partition;
+     FM_DEBUG("State after reversion - Cut size: ", partitionState_.getCurrentCutSize(),
+              ", Partition sizes: [", partitionState_.getPartitionSize(0), ", ",
+              partitionState_.getPartitionSize(1), "]");
+}
+
+void FMEngine::applyMove(int cellId, int toPartition) {
+    int fromPartition = cellPartition_[cellId];
     if (fromPartition == toPartition) {
         return; // No change needed
     }
 
-    // Calculate cutsize delta directly
-    int cutsizeDelta = -cell->gain; // Gain is the negative of cutsize change
-    
     // Remove cell from gain bucket and lock it
-    gainBucket_.removeCell(cell);
-    cell->locked = true;
-    
+    gainBucket_.removeCell(cellId);
+    cellLocked_[cellId] = 1;
+
+    // Move it; unlocked neighbors get their gains updated incrementally
+    relocateCell(cellId, toPartition);
+}
+
+void FMEngine::relocateCell(int cellId, int toPartition) {
+    int fromPartition = cellPartition_[cellId];
+    int cutsizeDelta = 0;
+
     // Update partition sizes
-    partitionState_.updatePartitionSize(fromPartition, -1);
-    partitionState_.updatePartitionSize(toPartition, 1);
+    int weight = graph_.getCellWeight(cellId);
+    partitionState_.updatePartitionSize(fromPartition, -weight);
+    partitionState_.updatePartitionSize(toPartition, weight);
     
     // Update net partition counts
-    for (int netId : cell->netIds) {
-        Net* net = netlist_.getNetById(netId); // Fetch net by ID
-        if (!net) continue;
+    for (int netId : graph_.getCellNets(cellId)) {
+        std::array<int, 2>& count = netPartitionCount_[netId];
 
         // --- Selective Gain Update --- START
-        // Store partition counts *before* the move for this net
-        int nF_before = net->partitionCount[fromPartition];
-        int nT_before = net->partitionCount[toPartition];
+        // Store partition count *before* the move for this net
+        int nT_before = count[toPartition];
 
         // Apply partition count change for this net
-        net->partitionCount[fromPartition]--;
-        net->partitionCount[toPartition]++;
+        count[fromPartition]--;
+        count[toPartition]++;
 
-        // Get partition counts *after* the move for this net
-        int nF_after = net->partitionCount[fromPartition];
-        int nT_after = net->partitionCount[toPartition];
+        // Get partition count *after* the move for this net
+        int nF_after = count[fromPartition];
+
+        // Track the cut directly from the count transitions
+        if (nT_before == 0 && nF_after > 0) {
+            cutsizeDelta += graph_.getNetWeight(netId);  // Net becomes cut
+        } else if (nF_after == 0 && nT_before > 0) {
+            cutsizeDelta -= graph_.getNetWeight(netId);  // Net becomes uncut
+        }
+
+        // Large nets have no part in gains, so their pins are never visited
+        int weight = netGainWeight_[netId];
+        if (weight == 0) {
+            continue;
+        }
 
         // Iterate through neighbors on this net to update their gains incrementally
-        for (int neighborCellId : net->cellIds) {
-            Cell* neighborCell = netlist_.getCellById(neighborCellId);
-            if (!neighborCell || neighborCell == cell || neighborCell->locked) {
-                continue; // Skip self, null, or locked cells
+        for (int neighborCellId : graph_.getNetPins(netId)) {
+            FM_STAT(neighborVisits_++);
+            if (neighborCellId == cellId || cellLocked_[neighborCellId]) {
+                continue; // Skip self or locked cells
             }
 
-            int oldGain = neighborCell->gain;
+            int neighborPartition = cellPartition_[neighborCellId];
+            int oldGain = cellGain_[neighborCellId];
             int gainDelta = 0;
 
             // --- Apply F-M Gain Update Rules ---
-            // Rule 1: If T becomes non-empty (net becomes cut)
-            if (nT_before == 0) { // T was empty, moving 'cell' makes it non-empty (1)
-                if (neighborCell->partition == fromPartition) {
-                    gainDelta++; // Increment gain of F neighbors
+            if (neighborPartition == fromPartition) {
+                // Rule 1: T was empty, so the net no longer counts against F cells (TE)
+                if (nT_before == 0) {
+                    gainDelta += weight;
                 }
-            }
-            // Rule 2: If F becomes empty (net becomes uncut)
-            if (nF_after == 0) { // F is now empty after move
-                if (neighborCell->partition == toPartition) {
-                    gainDelta++; // Increment gain of T neighbors
+                // Rule 2: the neighbor is now the only F cell; moving it would uncut the net (FS)
+                if (nF_after == 1) {
+                    gainDelta += weight;
                 }
-            }
-            // Rule 3: If T becomes non-singleton (had only 'cell')
-            if (nT_after == 1) { // T now has exactly one cell ('cell')
-                 if (neighborCell->partition == fromPartition) {
-                    gainDelta--; // Decrement gain of F neighbors
+            } else {
+                // Rule 3: the neighbor was the only T cell; moving it no longer uncuts the net
+                if (nT_before == 1) {
+                    gainDelta -= weight;
                 }
-            }
-             // Rule 4: If F becomes singleton (had only 'cell' and neighbor)
-            if (nF_before == 1) { // F had only 'cell' before the move
-                if (neighborCell->partition == toPartition) {
-                    gainDelta--; // Decrement gain of T neighbors
+                // Rule 4: F is now empty, so moving a T cell would cut the net
+                if (nF_after == 0) {
+                    gainDelta -= weight;
                 }
             }
             // --- End F-M Gain Update Rules ---
@@ -510,137 +584,213 @@ void FMEngine::applyMove(Cell* cell, int toPartition) {
 
             if (gainDelta != 0) {
                 int newGain = oldGain + gainDelta;
-                neighborCell->gain = newGain; // Update gain directly
-                gainBucket_.updateCellGain(neighborCell, oldGain, newGain); // Update bucket list
+                cellGain_[neighborCellId] = newGain; // Update gain directly
+                gainBucket_.updateCellGain(neighborCellId, oldGain, newGain); // Update bucket list
             }
         }
         // --- Selective Gain Update --- END
     }
 
     // Update cell's partition
-    cell->partition = toPartition;
+    cellPartition_[cellId] = toPartition;
 
-    // Update cutsize using the pre-calculated gain (delta)
+    // Update cutsize from the nets that changed state
     partitionState_.updateCutSize(cutsizeDelta);
-
-    // REMOVED: Update gains of neighbors AFTER partition counts and cell partition are updated
-    // updateGainsAfterMove(cell); // Replaced by inline logic above
-
-    // Reduced logging for performance
-    // std::cout << "    Move applied. New cut size: " << partitionState_.getCurrentCutSize()
-    //           << ", Partition sizes: [" << partitionState_.getPartitionSize(0)
-    //           << ", " << partitionState_.getPartitionSize(1) << "]" << std::endl;
 }
 
-int FMEngine::getMaxPossibleDegree() const {
-    // Find the cell with the maximum number of connected nets
-    int maxDegree = 0;
-    
-    for (const auto& cell : netlist_.getCells()) {
-        int degree = cell.netIds.size();
-        maxDegree = std::max(maxDegree, degree);
+int FMEngine::getMaxPossibleGain() const {
+    // The cell with the maximum number of connected nets bounds |gain|;
+    // with weighted or excluded nets, the largest per-cell sum of weights
+    int maxGain = graph_.getMaxCellDegree();
+    if (options_.largeNetThreshold > 0 ||
+        std::any_of(graph_.getNetWeights().begin(), graph_.getNetWeights().end(),
+                    [](int weight) { return weight != 1; })) {
+        maxGain = 0;
+        for (int cellId = 0; cellId < graph_.getNumCells(); cellId++) {
+            int cellGain = 0;
+            for (int netId : graph_.getCellNets(cellId)) {
+                if (options_.largeNetThreshold <= 0 ||
+                    graph_.getNetSize(netId) <= options_.largeNetThreshold) {
+                    cellGain += graph_.getNetWeight(netId);
+                }
+            }
+            maxGain = std::max(maxGain, cellGain);
+        }
     }
-    
+
     // If empty netlist, return a minimum size
-    if (maxDegree == 0) {
+    if (maxGain == 0) {
         return 10; // Default minimum size
     }
-    
-    return maxDegree;
+
+    return maxGain;
 }
 
-bool FMEngine::isMoveLegal(Cell* cell, int toPartition) const {
-    if (!cell || cell->locked) return false;
+bool FMEngine::isMoveLegal(int cellId, int toPartition) const {
+    if (cellId < 0 || cellLocked_[cellId]) return false;
 
-    int fromPartition = cell->partition;
+    int fromPartition = cellPartition_[cellId];
     if (fromPartition == toPartition) return false;
 
     // Check if move maintains balance
-    int newSize1 = partitionState_.getPartitionSize(fromPartition) - 1;
-    int newSize2 = partitionState_.getPartitionSize(toPartition) + 1;
+    int weight = graph_.getCellWeight(cellId);
+    int newSize1 = partitionState_.getPartitionSize(fromPartition) - weight;
+    int newSize2 = partitionState_.getPartitionSize(toPartition) + weight;
     
     return partitionState_.isBalanced(newSize1, newSize2);
 }
 
 void FMEngine::undoMove(const Move& move) {
-    Cell* cell = move.cell;
+    int cellId = move.cellId;
     int originalPartition = move.fromPartition;
-    int movedToPartition = move.toPartition;
-    // Reduced logging
-    // std::cout << "    Undoing move of cell " << cell->name << " from " << movedToPartition << " to " << originalPartition << std::endl;
-
-    // 1. Calculate the cutsize change to undo.
-    //    The original move changed cutsize by -move.gain (where move.gain was the gain *before* the move).
-    //    To reverse this, we add +move.gain.
-    int cutsizeDeltaUndo = move.gain;
-
-    // 2. Update partition sizes (reverse of applyMove)
-    partitionState_.updatePartitionSize(movedToPartition, -1);
-    partitionState_.updatePartitionSize(originalPartition, 1);
-
-    // 3. Update net partition counts (reverse of applyMove)
-    //    Do this BEFORE changing cell->partition
-    for (int netId : cell->netIds) {
-        Net* net = netlist_.getNetById(netId);
-        if (!net) continue;
-        net->partitionCount[movedToPartition]--;
-        net->partitionCount[originalPartition]++;
-    }
 
-    // 4. Restore cell's partition
-    cell->partition = originalPartition;
-
-    // 5. Unlock the cell
-    cell->locked = false;
-
-    // --- Gain Update during Undo ---
-    // 6. Update gains of neighbors based on the now reverted state.
-    //    It's simpler and safer for undo to just recalculate affected neighbor gains,
-    //    as undo operations are less frequent than forward moves.
-    std::unordered_set<Cell*> neighborsToUpdate;
-    for (int netId : cell->netIds) {
-         Net* net = netlist_.getNetById(netId);
-         if (!net) continue;
-         for (int neighborId : net->cellIds) {
-             Cell* neighbor = netlist_.getCellById(neighborId);
-             // Include the moved cell itself now as its gain needs recalculation too
-             if (neighbor && !neighbor->locked) {
-                 neighborsToUpdate.insert(neighbor);
-             }
-         }
+    // 1. Move the cell back. The same delta rules as applyMove, applied in
+    //    reverse, keep the gains of unlocked neighbors exact and the cut size
+    //    up to date, so an undo costs the same as the original move.
+    //    The cell is still locked here, so it is skipped as a neighbor.
+    relocateCell(cellId, originalPartition);
+
+    // 2. Unlock the cell; its gain went stale while it was locked
+    cellLocked_[cellId] = 0;
+    cellGain_[cellId] = calculateCellGain(cellId);
+
+    // 3. Add the cell back to the gain bucket with its recalculated gain
+    gainBucket_.addCell(cellId, originalPartition, cellGain_[cellId]);
+}
+
+int FMEngine::calculateCurrentCutSize() const {
+    // Chunked over nets on the pool while initializeState has one
+    return static_cast<int>(parallelSum(pool_.get(), graph_.getNumNets(), MIN_CHUNK,
+                                        [this](int begin, int end) {
+        long long cutSize = 0;
+        for (int netId = begin; netId < end; netId++) {
+            const std::array<int, 2>& count = netPartitionCount_[netId];
+            if (count[0] > 0 && count[1] > 0) {
+                cutSize += graph_.getNetWeight(netId);
+            }
+        }
+        return cutSize;
+    }));
+}
+
+bool FMEngine::verifyState() const {
+    bool consistent = true;
+
+    // Net partition counts and cut size
+    std::vector<std::array<int, 2>> counts(graph_.getNumNets(), {0, 0});
+    int partitionSize[2] = {0, 0};
+    for (int cellId = 0; cellId < graph_.getNumCells(); cellId++) {
+        partitionSize[cellPartition_[cellId]] += graph_.getCellWeight(cellId);
+        for (int netId : graph_.getCellNets(cellId)) {
+            counts[netId][cellPartition_[cellId]]++;
+        }
+    }
+    if (counts != netPartitionCount_) {
+        FM_ERROR("verifyState: net partition counts are inconsistent");
+        consistent = false;
     }
-    for (Cell* neighbor : neighborsToUpdate) {
-        if (neighbor == cell) continue; // Skip self here, handled below
-        int oldGain = neighbor->gain;
-        int newGain = calculateCellGain(neighbor); // Recalculate
-        if (oldGain != newGain) {
-             gainBucket_.updateCellGain(neighbor, oldGain, newGain);
+    if (calculateCurrentCutSize() != partitionState_.getCurrentCutSize()) {
+        FM_ERROR("verifyState: cut size ", partitionState_.getCurrentCutSize(), " should be ",
+                 calculateCurrentCutSize());
+        consistent = false;
+    }
+    for (int p = 0; p < 2; p++) {
+        if (partitionSize[p] != partitionState_.getPartitionSize(p)) {
+            FM_ERROR("verifyState: partition ", p, " size ", partitionState_.getPartitionSize(p),
+                     " should be ", partitionSize[p]);
+            consistent = false;
         }
     }
-    // --- End Neighbor Gain Update during Undo ---
-
-    // 7. Recalculate the gain of the moved cell itself in its original partition
-    int currentGain = calculateCellGain(cell);
-    cell->gain = currentGain;
 
-    // 8. Add the cell back to the gain bucket with its recalculated gain
-    gainBucket_.addCell(cell);
+    // Every unlocked cell must be bucketed under its exact gain
+    for (int cellId = 0; cellId < graph_.getNumCells(); cellId++) {
+        if (cellLocked_[cellId]) {
+            continue;
+        }
+        if (!gainBucket_.contains(cellId) || cellGain_[cellId] != calculateCellGain(cellId)) {
+            FM_ERROR("verifyState: cell ", cellLabel(cellId), " has gain ", cellGain_[cellId],
+                     ", expected ", calculateCellGain(cellId),
+                     (gainBucket_.contains(cellId) ? "" : " (not in bucket)"));
+            consistent = false;
+        }
+    }
+    return consistent;
+}
 
-    // 9. Apply the cutsize reversal *after* state is restored
-    partitionState_.updateCutSize(cutsizeDeltaUndo);
+const char* toString(StopReason reason) {
+    switch (reason) {
+    case StopReason::CONVERGED:      return "converged";
+    case StopReason::NO_IMPROVEMENT: return "no_improvement";
+    case StopReason::MAX_PASSES:     return "max_passes";
+    case StopReason::SLOW_PROGRESS:  return "slow_progress";
+    case StopReason::DEADLINE:       return "deadline";
+    case StopReason::STOP_REQUESTED: return "stop_requested";
+    case StopReason::ERROR:          return "error";
+    }
+    return "unknown";
+}
 
-    // Reduced logging
-    // std::cout << "    Undo complete. Cut size after undo: " << partitionState_.getCurrentCutSize() << std::endl;
+PassSummary FMStats::totals() const {
+    PassSummary total;
+    for (const PassSummary& pass : passes) {
+        total.moves += pass.moves;
+        total.keptMoves += pass.keptMoves;
+        total.revertedMoves += pass.revertedMoves;
+        total.bucketUpdates += pass.bucketUpdates;
+        total.neighborVisits += pass.neighborVisits;
+        total.bucketScans += pass.bucketScans;
+        total.seconds += pass.seconds;
+        total.moveSeconds += pass.moveSeconds;
+        total.rollbackSeconds += pass.rollbackSeconds;
+    }
+    if (!passes.empty()) {
+        total.threshold = passes.back().threshold;
+        total.cutSize = passes.back().cutSize;
+    } else {
+        total.cutSize = initialCutSize;  // Stopped (e.g. at the deadline) before any pass
+    }
+    return total;
 }
 
-int FMEngine::calculateCurrentCutSize() const {
-    int currentCutSize = 0;
-    for (const auto& net : netlist_.getNets()) {
-        if (net.partitionCount[0] > 0 && net.partitionCount[1] > 0) {
-            currentCutSize++;
-        }
+void writeStatsJson(std::ostream& out, const FMStats& stats) {
+    // Times in milliseconds, like fm_bench
+    auto writePass = [&out](const PassSummary& pass) {
+        out << "{\"moves\": " << pass.moves
+            << ", \"kept\": " << pass.keptMoves
+            << ", \"reverted\": " << pass.revertedMoves
+            << ", \"threshold\": " << pass.threshold
+            << ", \"cut\": " << pass.cutSize
+            << ", \"bucket_updates\": " << pass.bucketUpdates
+            << ", \"neighbor_visits\": " << pass.neighborVisits
+            << ", \"bucket_scans\": " << pass.bucketScans
+            << ", \"ms\": " << pass.seconds * 1000.0
+            << ", \"move_ms\": " << pass.moveSeconds * 1000.0
+            << ", \"rollback_ms\": " << pass.rollbackSeconds * 1000.0 << "}";
+    };
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"counters\": " << (FM_STATS_ENABLED ? "true" : "false")
+        << ",\n  \"init_ms\": " << stats.initSeconds * 1000.0
+        << ",\n  \"split_ms\": " << stats.splitSeconds * 1000.0
+        << ",\n  \"initial_cut\": " << stats.initialCutSize
+        << ",\n  \"stop_reason\": \"" << toString(stats.stopReason) << "\""
+        << ",\n  \"total\": ";
+    writePass(stats.totals());
+    out << ",\n  \"passes\": [";
+    for (size_t i = 0; i < stats.passes.size(); i++) {
+        out << (i ? "," : "") << "\n    ";
+        writePass(stats.passes[i]);
     }
-    return currentCutSize;
+    out << "\n  ]\n}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+std::string FMEngine::cellLabel(int cellId) const {
+    // Coarsened graphs carry no names
+    return graph_.hasNames() ? graph_.getCellName(cellId) : "#" + std::to_string(cellId);
 }
 
-} // namespace fm 
\ No newline at end of file
+} // namespace fm
\ No newline at end of file
@@ -1,53 +1,180 @@
 #pragma once
 
-#include "../DataStructures/Netlist.h"
+#include "../DataStructures/Hypergraph.h"
 #include "../DataStructures/PartitionState.h"
 #include "../DataStructures/GainBucket.h"
+#include "../DataStructures/EpochSet.h"
+#include "../Utils/ThreadPool.h"
+#include "InitialSplit.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 
 namespace fm {
 
+// When run() and runPass() stop. A pass may make at most
+// max(minThreshold, startThreshold - (pass - 1) * thresholdStep) moves in a
+// row without beating its best cut. Whenever run() stops, the partition is
+// the best one found so far: an interrupted pass is rolled back to its best
+// prefix like any other.
+struct StopPolicy {
+    using Clock = std::chrono::steady_clock;
+
+    int maxPasses = 50;
+    int maxPassesWithoutImprovement = 3;
+    int startThreshold = 2000;
+    int minThreshold = 500;
+    int thresholdStep = 100;
+    double minImprovementRate = 0.0;            // Cut reduction per second of the last pass (0 = off)
+    Clock::time_point deadline = Clock::time_point::max();  // Wall-clock limit (max = none)
+
+    bool hasDeadline() const { return deadline != Clock::time_point::max(); }
+    int threshold(int passCount) const {
+        return std::max(minThreshold, startThreshold - (passCount - 1) * thresholdStep);
+    }
+};
+
+// Why run() returned
+enum class StopReason {
+    CONVERGED,       // A pass found no improvement
+    NO_IMPROVEMENT,  // maxPassesWithoutImprovement passes without a lower cut
+    MAX_PASSES,
+    SLOW_PROGRESS,   // Below minImprovementRate
+    DEADLINE,
+    STOP_REQUESTED,  // requestStop()
+    ERROR            // Inconsistent state; see the log
+};
+const char* toString(StopReason reason);
+
+// Options for a single FM run
+struct FMOptions {
+    TieBreak tieBreak = TieBreak::LIFO;  // Equal-gain move selection
+    unsigned seed = 1;                   // Used by TieBreak::RANDOM
+    int largeNetThreshold = 0;           // Nets with more pins only count in the cut (0 = no limit)
+    int threads = 1;                     // Threads for state initialization (0 = hardware concurrency)
+    InitialSplit initialSplit = InitialSplit::SEQUENTIAL;  // When no partition is given
+    StopPolicy stop;
+};
+
 struct Move {
-    Cell* cell;
+    int cellId;
     int fromPartition;
     int toPartition;
     int gain;
     int resultingCutSize;
 };
 
+// Outcome of one pass, recorded by run(). The counters below the cut size
+// are only gathered with FM_STATS (on by default) and are 0 otherwise.
+struct PassSummary {
+    int moves = 0;                  // Moves made before rolling back
+    int keptMoves = 0;              // Moves kept (best prefix)
+    int revertedMoves = 0;          // Moves undone by the rollback
+    int threshold = 0;              // Moves allowed without improvement
+    int cutSize = 0;                // Cut size after the pass
+    long long bucketUpdates = 0;    // Gain bucket relinks (moves and undos)
+    long long neighborVisits = 0;   // Pins visited by the gain delta rules
+    long long bucketScans = 0;      // Candidates checked by getBestFeasibleCell
+    double seconds = 0.0;           // Wall time of the pass
+    double moveSeconds = 0.0;       // ... spent selecting and applying moves
+    double rollbackSeconds = 0.0;   // ... spent reverting and re-filing cells
+};
+
+// Everything run() records: construction time, one summary per pass and
+// why it stopped
+struct FMStats {
+    double initSeconds = 0.0;       // Initial partition, counts, gains, bucket
+    double splitSeconds = 0.0;      // ... of which building the initial partition
+    int initialCutSize = 0;         // Cut before the first pass
+    std::vector<PassSummary> passes;
+    StopReason stopReason = StopReason::CONVERGED;
+
+    PassSummary totals() const;     // Sums over all passes; cut of the last (initial if none)
+};
+
+// Writes stats as one JSON object ("counters" tells whether FM_STATS was on)
+void writeStatsJson(std::ostream& out, const FMStats& stats);
+
 class FMEngine {
 public:
-    // Constructor
-    FMEngine(Netlist& netlist, double balanceFactor);
+    // Constructors. The first starts from options.initialSplit; the second
+    // starts from a given assignment (0/1 per cell), e.g. a projected
+    // multilevel solution, which must satisfy the balance constraint. The
+    // second throws std::invalid_argument if the assignment does not have
+    // one 0 or 1 per cell.
+    FMEngine(const Hypergraph& graph, double balanceFactor,
+             const FMOptions& options = FMOptions());
+    FMEngine(const Hypergraph& graph, double balanceFactor,
+             const std::vector<int>& initialPartition,
+             const FMOptions& options = FMOptions());
+
+    // Main algorithm methods. Returns the stats of this run (also
+    // available from getStats()).
+    const FMStats& run();
+
+    // Makes a running run() finish early with the best partition so far.
+    // Safe to call from any thread; checked every few dozen moves.
+    void requestStop() { stopRequested_.store(true, std::memory_order_relaxed); }
 
-    // Main algorithm methods
-    void run();
-    
     // Accessor for partition state
     const PartitionState& getPartitionState() const { return partitionState_; }
-    
+
+    // Accessors for per-cell / per-net state (indexed by ID)
+    const std::vector<int>& getCellPartitions() const { return cellPartition_; }
+    const std::array<int, 2>& getNetPartitionCount(int netId) const { return netPartitionCount_[netId]; }
+    const Hypergraph& getGraph() const { return graph_; }
+    const std::vector<PassSummary>& getPassSummaries() const { return stats_.passes; }
+    const FMStats& getStats() const { return stats_; }
+
 private:
-    Netlist& netlist_;
+    const Hypergraph& graph_;
+    FMOptions options_;
     PartitionState partitionState_;
     GainBucket gainBucket_;
     std::vector<Move> moveHistory_;
+    FMStats stats_;
+    std::atomic<bool> stopRequested_{false};
+    long long neighborVisits_ = 0;       // Running total, see Utils/Stats.h
+
+    // Structure-of-arrays partitioning state
+    std::vector<int> cellPartition_;                   // 0 for G1, 1 for G2
+    std::vector<int> cellGain_;
+    std::vector<char> cellLocked_;
+    std::vector<std::array<int, 2>> netPartitionCount_; // Cells of each net in G1 / G2
+    std::vector<int> netGainWeight_;                   // Net weight in gains; 0 for large nets
+
+    // Reusable per-cell scratch set (sized once, cleared in O(1))
+    EpochSet movedCells_;                // Cells moved in the current pass
+
+    // Workers for initializeState, alive only while it runs (threads != 1)
+    std::unique_ptr<ThreadPool> pool_;
 
     // Core algorithm steps
     void initializePartitions();
+    void initializeState();
     bool runPass(int passCount);
-    
+    bool shouldInterrupt() const;  // Deadline passed or stop requested
+    StopReason interruptReason() const;
+
     // Helper methods
     void calculateInitialGains();
-    void updateGainsAfterMove(Cell* movedCell);
-    int calculateCellGain(Cell* cell) const;
+    int calculateCellGain(int cellId) const;
     void revertMovesToBestState(int bestMoveIndex, int initialCutSize);
-    void applyMove(Cell* cell, int toPartition);
+    void applyMove(int cellId, int toPartition);
     void undoMove(const Move& move);
-    
+    void relocateCell(int cellId, int toPartition);  // Counts, neighbor gains, cut, side
+
     // Utility methods
-    int getMaxPossibleDegree() const;
-    bool isMoveLegal(Cell* cell, int toPartition) const;
+    int getMaxPossibleGain() const;  // Bounds |gain|; sizes the gain bucket
+    bool isMoveLegal(int cellId, int toPartition) const;
     int calculateCurrentCutSize() const;
+    bool verifyState() const;  // Full recompute check; used with FM_DEBUG_CHECKS
+    std::string cellLabel(int cellId) const;
 };
 
-} // namespace fm 
\ No newline at end of file
+} // namespace fm
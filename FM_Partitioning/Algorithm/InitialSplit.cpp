@@ -0,0 +1,115 @@
+#include "InitialSplit.h"
+#include "Reorder.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace fm {
+
+namespace {
+
+std::vector<int> clusterOrder(const Hypergraph& graph) {
+    const int numCells = graph.getNumCells();
+    const int numNets = graph.getNumNets();
+
+    // Nets by ascending size (counting sort, stable in net ID)
+    int maxSize = 0;
+    for (int netId = 0; netId < numNets; netId++) {
+        maxSize = std::max(maxSize, graph.getNetSize(netId));
+    }
+    std::vector<int> sizeStart(maxSize + 2, 0);
+    for (int netId = 0; netId < numNets; netId++) {
+        sizeStart[graph.getNetSize(netId) + 1]++;
+    }
+    std::partial_sum(sizeStart.begin(), sizeStart.end(), sizeStart.begin());
+    std::vector<int> nets(numNets);
+    for (int netId = 0; netId < numNets; netId++) {
+        nets[sizeStart[graph.getNetSize(netId)]++] = netId;
+    }
+
+    // A cell joins the order with the smallest net it is on, next to that
+    // net's other pins
+    std::vector<int> order;
+    order.reserve(numCells);
+    std::vector<char> cellSeen(numCells, 0);
+    for (int netId : nets) {
+        for (int pin : graph.getNetPins(netId)) {
+            if (!cellSeen[pin]) {
+                cellSeen[pin] = 1;
+                order.push_back(pin);
+            }
+        }
+    }
+    for (int cellId = 0; cellId < numCells; cellId++) {
+        if (!cellSeen[cellId]) {
+            order.push_back(cellId);  // Cells on no net
+        }
+    }
+    return order;
+}
+
+// G1 takes cells along the order until it holds half the total weight
+std::vector<int> splitOrder(const Hypergraph& graph, const std::vector<int>& order) {
+    std::vector<int> partition(graph.getNumCells(), 1);
+    int targetSize = graph.getTotalCellWeight() / 2;
+    int partition0Size = 0;
+    for (int cellId : order) {
+        if (partition0Size >= targetSize) {
+            break;
+        }
+        partition[cellId] = 0;
+        partition0Size += graph.getCellWeight(cellId);
+    }
+    return partition;
+}
+
+std::vector<int> randomSplit(const Hypergraph& graph, unsigned seed) {
+    // Shuffle the cells and send each one to the currently lighter side
+    std::mt19937 rng(seed);
+    std::vector<int> order(graph.getNumCells());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<int> partition(graph.getNumCells());
+    int sideWeight[2] = {0, 0};
+    for (int cellId : order) {
+        int side = sideWeight[1] < sideWeight[0] ? 1 : 0;
+        partition[cellId] = side;
+        sideWeight[side] += graph.getCellWeight(cellId);
+    }
+    return partition;
+}
+
+} // namespace
+
+const char* toString(InitialSplit split) {
+    switch (split) {
+    case InitialSplit::SEQUENTIAL: return "sequential";
+    case InitialSplit::RANDOM:     return "random";
+    case InitialSplit::BFS:        return "bfs";
+    case InitialSplit::CLUSTER:    return "cluster";
+    }
+    return "unknown";
+}
+
+std::vector<int> makeInitialSplit(const Hypergraph& graph, InitialSplit split, unsigned seed) {
+    if (graph.getNumCells() == 0) {
+        return {};
+    }
+    switch (split) {
+    case InitialSplit::RANDOM:
+        return randomSplit(graph, seed);
+    case InitialSplit::BFS:
+        return splitOrder(graph, bfsCellOrder(graph, false));
+    case InitialSplit::CLUSTER:
+        return splitOrder(graph, clusterOrder(graph));
+    case InitialSplit::SEQUENTIAL:
+    default: {
+        std::vector<int> order(graph.getNumCells());
+        std::iota(order.begin(), order.end(), 0);
+        return splitOrder(graph, order);
+    }
+    }
+}
+
+} // namespace fm
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../DataStructures/Hypergraph.h"
+#include <vector>
+
+namespace fm {
+
+// How FMEngine builds its starting partition. SEQUENTIAL, BFS and CLUSTER
+// put cells in some order and fill G1 along it up to half the total
+// weight; RANDOM sends shuffled cells to the currently lighter side.
+enum class InitialSplit {
+    SEQUENTIAL,  // Cell ID (parse) order
+    RANDOM,      // Shuffled with the run's seed
+    BFS,         // Breadth-first growth from a pseudo-peripheral cell
+    CLUSTER      // Pins of small nets first, so cells sharing a net stay together
+};
+const char* toString(InitialSplit split);
+
+// Side (0/1) per cell
+std::vector<int> makeInitialSplit(const Hypergraph& graph, InitialSplit split, unsigned seed);
+
+} // namespace fm
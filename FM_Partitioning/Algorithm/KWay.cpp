@@ -0,0 +1,198 @@
+#include "KWay.h"
+#include "FMEngine.h"
+#include "../DataStructures/PartitionState.h"
+#include "../Utils/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace fm {
+
+KWayPartitioner::KWayPartitioner(const Hypergraph& graph, double balanceFactor,
+                                 const KWayOptions& options)
+    : graph_(graph)
+    , balanceFactor_(balanceFactor)
+    , options_(options) {
+    int k = options_.numBlocks;
+    if (k < 2 || (k & (k - 1)) != 0) {
+        throw std::invalid_argument("k-way partitioning needs a power of two of at least 2 blocks");
+    }
+}
+
+void KWayPartitioner::run() {
+    const int k = options_.numBlocks;
+    FM_INFO("Starting ", k, "-way partitioning (",
+            options_.objective == KWayObjective::CUT ? "cut" : "km1", " objective)...");
+
+    cellBlock_.assign(graph_.getNumCells(), 0);
+    std::vector<int> toInput(graph_.getNumCells());
+    std::iota(toInput.begin(), toInput.end(), 0);
+    bisect(graph_, toInput, 0, k);
+
+    computeMetrics();
+    for (int block = 0; block < k; block++) {
+        FM_DEBUG("Block ", block, " weight: ", blockWeight_[block]);
+    }
+    if (!isBalanced()) {
+        std::pair<int, int> limits = PartitionState::blockLimits(graph_.getTotalCellWeight(), k,
+                                                                 balanceFactor_);
+        FM_WARNING("Warning: Some blocks are outside the balance window [", limits.first, ", ",
+                   limits.second, "]");
+    }
+    FM_INFO(k, "-way partitioning completed. Cut size: ", cutSize_,
+            ", connectivity - 1: ", connectivity_);
+}
+
+int KWayPartitioner::getObjectiveValue() const {
+    return options_.objective == KWayObjective::CUT ? cutSize_ : connectivity_;
+}
+
+const char* KWayPartitioner::getObjectiveName() const {
+    return options_.objective == KWayObjective::CUT ? "Cutsize" : "KM1";
+}
+
+bool KWayPartitioner::isBalanced() const {
+    std::pair<int, int> limits = PartitionState::blockLimits(graph_.getTotalCellWeight(),
+                                                             options_.numBlocks, balanceFactor_);
+    for (int weight : blockWeight_) {
+        if (weight < limits.first || weight > limits.second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void KWayPartitioner::bisect(const Hypergraph& graph, const std::vector<int>& toInput,
+                             int firstBlock, int numBlocks) {
+    FM_INFO("Bisecting blocks ", firstBlock, "-", firstBlock + numBlocks - 1, ": ",
+            graph.getNumCells(), " cells, ", graph.getNumNets(), " nets");
+    double balanceFactor = bisectionBalanceFactor(graph.getTotalCellWeight(), numBlocks);
+    FM_DEBUG("Bisection balance factor: ", balanceFactor);
+    std::vector<int> side = bisectGraph(graph, balanceFactor);
+    const int half = numBlocks / 2;
+
+    if (half == 1) {
+        // Leaves: the two sides are final blocks
+        for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+            cellBlock_[toInput[cellId]] = firstBlock + side[cellId];
+        }
+        return;
+    }
+
+    for (int sideId = 0; sideId < 2; sideId++) {
+        std::vector<int> sideCells;
+        Hypergraph child = extractSide(graph, side, sideId, sideCells);
+        std::vector<int> childToInput(sideCells.size());
+        for (size_t i = 0; i < sideCells.size(); i++) {
+            childToInput[i] = toInput[sideCells[i]];
+        }
+        bisect(child, childToInput, firstBlock + sideId * half, half);
+    }
+}
+
+double KWayPartitioner::bisectionBalanceFactor(int weight, int numBlocks) const {
+    // Splitting weight w into numBlocks blocks takes d = log2(numBlocks)
+    // more bisections. With factor r' at each of them a block ends up in
+    // w/numBlocks * [(1 - r')^d, (1 + r')^d], which has to sit inside the
+    // k-way window [L, U]:
+    //   r' <= (U * numBlocks / w)^(1/d) - 1  and  r' <= 1 - (L * numBlocks / w)^(1/d)
+    int levels = 0;
+    while ((1 << levels) < numBlocks) {
+        levels++;
+    }
+    double blockSize = static_cast<double>(graph_.getTotalCellWeight()) / options_.numBlocks;
+    double upper = blockSize * (1.0 + balanceFactor_) * numBlocks / weight;
+    double lower = blockSize * (1.0 - balanceFactor_) * numBlocks / weight;
+    double factor = std::min(std::pow(upper, 1.0 / levels) - 1.0,
+                             1.0 - std::pow(lower, 1.0 / levels));
+    // An odd weight cannot be halved exactly: below 1/w the rounded window
+    // of the bisection is empty (min > max), so allow the one unit of slack
+    return std::max(weight > 0 ? 1.0 / weight : 0.0, factor);
+}
+
+std::vector<int> KWayPartitioner::bisectGraph(const Hypergraph& graph, double balanceFactor) const {
+    if (graph.getNumCells() < 2) {
+        return std::vector<int>(graph.getNumCells(), 0);  // Nothing to split
+    }
+
+    if (options_.multilevel) {
+        MultilevelPartitioner partitioner(graph, balanceFactor, options_.multilevelOptions);
+        partitioner.run();
+        return partitioner.getEngine().getCellPartitions();
+    }
+
+    FMEngine engine(graph, balanceFactor, options_.fmOptions);
+    engine.run();
+    return engine.getCellPartitions();
+}
+
+Hypergraph KWayPartitioner::extractSide(const Hypergraph& graph, const std::vector<int>& side,
+                                        int sideId, std::vector<int>& sideCells) const {
+    // Renumber the side's cells densely, keeping their relative order
+    std::vector<int> localId(graph.getNumCells(), -1);
+    std::vector<int> cellWeights;
+    sideCells.clear();
+    for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+        if (side[cellId] == sideId) {
+            localId[cellId] = static_cast<int>(sideCells.size());
+            sideCells.push_back(cellId);
+            cellWeights.push_back(graph.getCellWeight(cellId));
+        }
+    }
+
+    // Restrict nets to the side. Nets left with a single pin cannot be cut
+    // any further; under CUT a net that crosses the bisection is dropped too.
+    std::vector<int> netPinOffsets = {0};
+    std::vector<int> netPins;
+    std::vector<int> netWeights;
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
+        size_t netStart = netPins.size();
+        bool crossing = false;
+        for (int cellId : graph.getNetPins(netId)) {
+            if (side[cellId] == sideId) {
+                netPins.push_back(localId[cellId]);
+            } else {
+                crossing = true;
+            }
+        }
+        if (netPins.size() - netStart < 2 || (crossing && options_.objective == KWayObjective::CUT)) {
+            netPins.resize(netStart);
+        } else {
+            netPinOffsets.push_back(static_cast<int>(netPins.size()));
+            netWeights.push_back(graph.getNetWeight(netId));
+        }
+    }
+
+    return Hypergraph(std::move(netPinOffsets), std::move(netPins), std::move(cellWeights),
+                      std::move(netWeights));
+}
+
+void KWayPartitioner::computeMetrics() {
+    blockWeight_.assign(options_.numBlocks, 0);
+    for (int cellId = 0; cellId < graph_.getNumCells(); cellId++) {
+        blockWeight_[cellBlock_[cellId]] += graph_.getCellWeight(cellId);
+    }
+
+    // Blocks spanned per net, counted with one stamp per block
+    cutSize_ = 0;
+    connectivity_ = 0;
+    std::vector<int> stamp(options_.numBlocks, -1);
+    for (int netId = 0; netId < graph_.getNumNets(); netId++) {
+        int blocksSpanned = 0;
+        for (int cellId : graph_.getNetPins(netId)) {
+            int block = cellBlock_[cellId];
+            if (stamp[block] != netId) {
+                stamp[block] = netId;
+                blocksSpanned++;
+            }
+        }
+        if (blocksSpanned > 1) {
+            cutSize_ += graph_.getNetWeight(netId);
+            connectivity_ += (blocksSpanned - 1) * graph_.getNetWeight(netId);
+        }
+    }
+}
+
+} // namespace fm
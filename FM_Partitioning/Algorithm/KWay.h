@@ -0,0 +1,74 @@
+#pragma once
+
+#include "FMEngine.h"
+#include "Multilevel.h"
+#include "../DataStructures/Hypergraph.h"
+#include <vector>
+
+namespace fm {
+
+// Quantity minimized across the k blocks
+enum class KWayObjective {
+    CUT,  // Weight of nets spanning more than one block
+    KM1   // Connectivity - 1: sum over nets of weight * (blocks spanned - 1)
+};
+
+// Options for k-way partitioning
+struct KWayOptions {
+    int numBlocks = 2;                          // k; must be a power of two
+    KWayObjective objective = KWayObjective::CUT;
+    bool multilevel = false;                    // Bisect with MultilevelPartitioner instead of FMEngine
+    MultilevelOptions multilevelOptions;        // Used when multilevel is set
+    FMOptions fmOptions;                        // Every flat bisection
+};
+
+// Recursive bisection into k blocks. Every bisection runs FMEngine (or the
+// multilevel V-cycle) on a sub-hypergraph extracted from the in-memory
+// parent, so the input is parsed once. The objective decides what the
+// children inherit: for CUT a net cut by a bisection is already paid for
+// and is dropped, for KM1 each side keeps its part of the net, since every
+// further block it spans costs one more.
+//
+// Each bisection runs with a balance factor derived from the weight it
+// actually splits: compounded over the levels still below it, every block
+// lands inside the k-way window from PartitionState::blockLimits. Slack
+// left unused by one bisection is passed on to the next.
+class KWayPartitioner {
+public:
+    // Constructor
+    KWayPartitioner(const Hypergraph& graph, double balanceFactor,
+                    const KWayOptions& options = KWayOptions());
+
+    // Main algorithm method
+    void run();
+
+    // Results (valid after run)
+    const std::vector<int>& getCellBlocks() const { return cellBlock_; }  // Block per cell
+    const std::vector<int>& getBlockWeights() const { return blockWeight_; }
+    int getNumBlocks() const { return options_.numBlocks; }
+    int getCutSize() const { return cutSize_; }
+    int getConnectivity() const { return connectivity_; }  // KM1 value
+    int getObjectiveValue() const;
+    const char* getObjectiveName() const;  // Output label: "Cutsize" or "KM1"
+    bool isBalanced() const;  // Every block inside the k-way window
+
+private:
+    const Hypergraph& graph_;
+    double balanceFactor_;
+    KWayOptions options_;
+    std::vector<int> cellBlock_;
+    std::vector<int> blockWeight_;
+    int cutSize_ = 0;
+    int connectivity_ = 0;
+
+    // Helper methods
+    void bisect(const Hypergraph& graph, const std::vector<int>& toInput,
+                int firstBlock, int numBlocks);
+    double bisectionBalanceFactor(int weight, int numBlocks) const;
+    std::vector<int> bisectGraph(const Hypergraph& graph, double balanceFactor) const;
+    Hypergraph extractSide(const Hypergraph& graph, const std::vector<int>& side, int sideId,
+                           std::vector<int>& sideCells) const;
+    void computeMetrics();
+};
+
+} // namespace fm
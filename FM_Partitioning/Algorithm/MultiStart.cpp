@@ -0,0 +1,54 @@
+#include "MultiStart.h"
+#include "../Utils/Logger.h"
+#include "../Utils/ThreadPool.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace fm {
+
+MultiStartPartitioner::MultiStartPartitioner(const Hypergraph& graph, double balanceFactor,
+                                             const MultiStartOptions& options)
+    : graph_(graph)
+    , balanceFactor_(balanceFactor)
+    , options_(options) {
+}
+
+void MultiStartPartitioner::run() {
+    const int starts = std::max(1, options_.starts);
+    int threads = options_.threads > 0 ? options_.threads
+                                       : static_cast<int>(std::thread::hardware_concurrency());
+    ThreadPool pool(std::max(1, std::min(threads, starts)));
+    FM_INFO("Starting ", starts, " F-M runs on ", pool.getNumThreads(), " threads...");
+
+    bestEngine_.reset();
+    bestStart_ = -1;
+    std::mutex bestMutex;
+
+    for (int start = 0; start < starts; start++) {
+        pool.submit([this, start, &bestMutex] {
+            FMOptions fmOptions = options_.fmOptions;
+            fmOptions.seed = options_.seed + start;
+            fmOptions.threads = 1;  // The starts already fill the pool
+            fmOptions.initialSplit = InitialSplit::RANDOM;
+            auto engine = std::make_unique<FMEngine>(graph_, balanceFactor_, fmOptions);
+            engine->run();
+            int cutSize = engine->getPartitionState().getCurrentCutSize();
+
+            // Only the best engine is kept alive
+            std::lock_guard<std::mutex> lock(bestMutex);
+            FM_INFO("Start ", start, " finished with cut size ", cutSize);
+            if (!bestEngine_ || cutSize < bestEngine_->getPartitionState().getCurrentCutSize() ||
+                (cutSize == bestEngine_->getPartitionState().getCurrentCutSize() && start < bestStart_)) {
+                bestEngine_ = std::move(engine);
+                bestStart_ = start;
+            }
+        });
+    }
+    pool.wait();
+
+    FM_INFO("Multi-start completed. Best start: ", bestStart_, ", cut size: ",
+            bestEngine_->getPartitionState().getCurrentCutSize());
+}
+
+} // namespace fm
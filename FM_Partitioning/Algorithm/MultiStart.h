@@ -0,0 +1,44 @@
+#pragma once
+
+#include "FMEngine.h"
+#include "../DataStructures/Hypergraph.h"
+#include <memory>
+#include <vector>
+
+namespace fm {
+
+// Options for multi-start partitioning
+struct MultiStartOptions {
+    int starts = 1;      // Independent FM runs
+    int threads = 0;     // Worker threads (0 = hardware concurrency)
+    unsigned seed = 1;   // Start i uses seed + i for its initial partition
+    FMOptions fmOptions; // Start i runs with seed + i
+};
+
+// Runs independent FMEngine instances from different random balanced
+// initial partitions on a thread pool. Every engine owns its own partition
+// and gain state over the shared, read-only hypergraph. The lowest cut wins;
+// ties go to the lowest start index, so the result does not depend on the
+// thread count or scheduling.
+class MultiStartPartitioner {
+public:
+    // Constructor
+    MultiStartPartitioner(const Hypergraph& graph, double balanceFactor,
+                          const MultiStartOptions& options = MultiStartOptions());
+
+    // Main algorithm method
+    void run();
+
+    // Best engine found (valid after run)
+    const FMEngine& getEngine() const { return *bestEngine_; }
+    int getBestStart() const { return bestStart_; }
+
+private:
+    const Hypergraph& graph_;
+    double balanceFactor_;
+    MultiStartOptions options_;
+    std::unique_ptr<FMEngine> bestEngine_;
+    int bestStart_ = -1;
+};
+
+} // namespace fm
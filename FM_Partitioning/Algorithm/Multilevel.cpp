@@ -0,0 +1,269 @@
+#include "Multilevel.h"
+#include "InitialSplit.h"
+#include "../Utils/Logger.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace fm {
+
+MultilevelPartitioner::MultilevelPartitioner(const Hypergraph& graph, double balanceFactor,
+                                             const MultilevelOptions& options)
+    : graph_(graph)
+    , balanceFactor_(balanceFactor)
+    , options_(options)
+    , rng_(options.seed) {
+}
+
+void MultilevelPartitioner::run() {
+    FM_INFO("Starting multilevel partitioning...");
+    levels_.clear();
+    coarsen();
+
+    // Partition the coarsest level, then project and refine level by level
+    const Hypergraph& coarsest = levels_.empty() ? graph_ : levels_.back().graph;
+    std::vector<int> partition = partitionCoarsest(coarsest);
+    if (partition.empty() && !levels_.empty()) {
+        // Clusters too heavy to split within the window. Start over on the
+        // input, whose unit-weight cells split as evenly as any partition can
+        FM_WARNING("Warning: No balanced split of the coarsest level; partitioning the input instead");
+        levels_.clear();
+        partition = partitionCoarsest(graph_);
+    }
+    if (partition.empty()) {
+        throw std::runtime_error("No split meets the balance window for balance factor " +
+                                 std::to_string(balanceFactor_));
+    }
+
+    if (levels_.empty()) {
+        // Nothing was coarsened; polish the best split of the input itself
+        engine_ = std::make_unique<FMEngine>(graph_, balanceFactor_, partition, fmOptions(0));
+        engine_->run();
+    }
+    for (int level = static_cast<int>(levels_.size()) - 1; level >= 0; level--) {
+        // Every fine cell inherits the side of its cluster
+        const Hypergraph& fine = finerGraph(level);
+        const std::vector<int>& fineToCoarse = levels_[level].fineToCoarse;
+        std::vector<int> finePartition(fine.getNumCells());
+        for (int cellId = 0; cellId < fine.getNumCells(); cellId++) {
+            finePartition[cellId] = partition[fineToCoarse[cellId]];
+        }
+
+        FM_INFO("Refining level ", level, " projected onto ", fine.getNumCells(), " cells");
+        engine_ = std::make_unique<FMEngine>(fine, balanceFactor_, finePartition, fmOptions(0, level > 0));
+        engine_->run();
+        partition = engine_->getCellPartitions();
+    }
+
+    FM_INFO("Multilevel partitioning completed. Final cut size: ",
+            engine_->getPartitionState().getCurrentCutSize());
+}
+
+void MultilevelPartitioner::coarsen() {
+    // Cap cluster weights so the coarsest level can still be split within the
+    // balance window, and so clusters stay roughly uniform in size
+    int totalWeight = graph_.getTotalCellWeight();
+    int balanceCap = static_cast<int>(std::floor(balanceFactor_ * totalWeight / 4.0));
+    int sizeCap = static_cast<int>(std::ceil(1.5 * totalWeight / std::max(1, options_.coarsestSize)));
+    int maxClusterWeight = std::max(1, std::min(balanceCap, sizeCap));
+
+    while (static_cast<int>(levels_.size()) < options_.maxLevels) {
+        const Hypergraph& fine = levels_.empty() ? graph_ : levels_.back().graph;
+        if (fine.getNumCells() <= options_.coarsestSize) {
+            break;
+        }
+
+        Level level;
+        if (!coarsenLevel(fine, maxClusterWeight, level)) {
+            break;
+        }
+        FM_INFO("Coarsened level ", levels_.size(), ": ", level.graph.getNumCells(), " cells, ",
+                level.graph.getNumNets(), " nets, ", level.graph.getNumPins(), " pins");
+        levels_.push_back(std::move(level));
+    }
+}
+
+bool MultilevelPartitioner::coarsenLevel(const Hypergraph& fine, int maxClusterWeight, Level& level) {
+    const int numCells = fine.getNumCells();
+
+    // Visit cells in random order so clusters do not follow the input order
+    std::vector<int> order(numCells);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng_);
+
+    // First-choice clustering: join each unclustered cell to the neighbor
+    // (clustered or not) it shares the most heavily rated nets with
+    std::vector<int> cluster(numCells, -1);
+    std::vector<int> clusterWeight;
+    std::vector<double> rating(numCells, 0.0);
+    std::vector<int> touched;
+
+    for (int cellId : order) {
+        if (cluster[cellId] >= 0) {
+            continue;
+        }
+
+        for (int netId : fine.getCellNets(cellId)) {
+            int netSize = fine.getNetSize(netId);
+            if (netSize < 2 || netSize > options_.largeNetSize) {
+                continue;
+            }
+            double score = static_cast<double>(fine.getNetWeight(netId)) / (netSize - 1);
+            for (int neighborId : fine.getNetPins(netId)) {
+                if (neighborId == cellId) {
+                    continue;
+                }
+                if (rating[neighborId] == 0.0) {
+                    touched.push_back(neighborId);
+                }
+                rating[neighborId] += score;
+            }
+        }
+
+        int weight = fine.getCellWeight(cellId);
+        int bestNeighbor = -1;
+        double bestRating = 0.0;
+        int bestWeight = INT_MAX;
+        for (int neighborId : touched) {
+            int targetWeight = cluster[neighborId] >= 0 ? clusterWeight[cluster[neighborId]]
+                                                        : fine.getCellWeight(neighborId);
+            if (targetWeight + weight <= maxClusterWeight &&
+                (rating[neighborId] > bestRating ||
+                 (rating[neighborId] == bestRating && targetWeight < bestWeight))) {
+                bestNeighbor = neighborId;
+                bestRating = rating[neighborId];
+                bestWeight = targetWeight;
+            }
+            rating[neighborId] = 0.0;
+        }
+        touched.clear();
+
+        if (bestNeighbor < 0) {
+            cluster[cellId] = static_cast<int>(clusterWeight.size());
+            clusterWeight.push_back(weight);
+        } else if (cluster[bestNeighbor] < 0) {
+            cluster[cellId] = cluster[bestNeighbor] = static_cast<int>(clusterWeight.size());
+            clusterWeight.push_back(weight + fine.getCellWeight(bestNeighbor));
+        } else {
+            cluster[cellId] = cluster[bestNeighbor];
+            clusterWeight[cluster[cellId]] += weight;
+        }
+    }
+
+    const int numClusters = static_cast<int>(clusterWeight.size());
+    if (numClusters > options_.minReduction * numCells) {
+        return false;  // Coarsening has stalled
+    }
+
+    // Contract nets onto clusters. Duplicate pins are dropped and nets left
+    // inside a single cluster can never be cut, so they are dropped too.
+    // Nets that end up on the same clusters are merged into one carrying
+    // their summed weight. The cut of a coarse partition is then exactly the
+    // cut of its projection.
+    std::vector<int> netPinOffsets = {0};
+    std::vector<int> netPins;
+    std::vector<int> netWeights;
+    netPinOffsets.reserve(fine.getNumNets() + 1);
+    netPins.reserve(fine.getNumPins());
+    netWeights.reserve(fine.getNumNets());
+    std::vector<int> stamp(numClusters, -1);
+    std::unordered_map<uint64_t, int> netByHash;  // Pin hash -> last coarse net with it
+    std::vector<int> sameHashNet;                 // Coarse net -> previous one with its hash
+    netByHash.reserve(fine.getNumNets());
+    sameHashNet.reserve(fine.getNumNets());
+    for (int netId = 0; netId < fine.getNumNets(); netId++) {
+        size_t netStart = netPins.size();
+        for (int cellId : fine.getNetPins(netId)) {
+            int clusterId = cluster[cellId];
+            if (stamp[clusterId] != netId) {
+                stamp[clusterId] = netId;
+                netPins.push_back(clusterId);
+            }
+        }
+        if (netPins.size() - netStart < 2) {
+            netPins.resize(netStart);
+            continue;
+        }
+
+        std::sort(netPins.begin() + netStart, netPins.end());
+        uint64_t hash = 14695981039346656037ULL;  // FNV-1a over the sorted pins
+        for (size_t pin = netStart; pin < netPins.size(); pin++) {
+            hash = (hash ^ static_cast<uint64_t>(netPins[pin])) * 1099511628211ULL;
+        }
+
+        auto found = netByHash.find(hash);
+        int parallelNet = found == netByHash.end() ? -1 : found->second;
+        for (; parallelNet >= 0; parallelNet = sameHashNet[parallelNet]) {
+            int otherStart = netPinOffsets[parallelNet];
+            int otherSize = netPinOffsets[parallelNet + 1] - otherStart;
+            if (otherSize == static_cast<int>(netPins.size() - netStart) &&
+                std::equal(netPins.begin() + netStart, netPins.end(), netPins.begin() + otherStart)) {
+                break;
+            }
+        }
+
+        if (parallelNet >= 0) {
+            netWeights[parallelNet] += fine.getNetWeight(netId);
+            netPins.resize(netStart);
+        } else {
+            int coarseNetId = static_cast<int>(netWeights.size());
+            sameHashNet.push_back(found == netByHash.end() ? -1 : found->second);
+            netByHash[hash] = coarseNetId;
+            netPinOffsets.push_back(static_cast<int>(netPins.size()));
+            netWeights.push_back(fine.getNetWeight(netId));
+        }
+    }
+
+    if (netPins.size() > options_.minPinReduction * fine.getNumPins()) {
+        return false;  // Clusters merge, but the nets between them do not shrink
+    }
+
+    level.graph = Hypergraph(std::move(netPinOffsets), std::move(netPins), std::move(clusterWeight),
+                             std::move(netWeights));
+    level.fineToCoarse = std::move(cluster);
+    return true;
+}
+
+std::vector<int> MultilevelPartitioner::partitionCoarsest(const Hypergraph& coarsest) {
+    std::vector<int> bestPartition;
+    int bestCutSize = INT_MAX;
+    for (int attempt = 0; attempt < std::max(1, options_.initialTries); attempt++) {
+        // Random split, seeded from this partitioner's stream so every
+        // attempt (and every call) starts somewhere else
+        std::vector<int> partition = makeInitialSplit(coarsest, InitialSplit::RANDOM, rng_());
+
+        FMEngine engine(coarsest, balanceFactor_, partition, fmOptions(attempt, true));
+        const PartitionState& state = engine.getPartitionState();
+        if (!state.isBalanced(state.getPartitionSize(0), state.getPartitionSize(1))) {
+            continue;
+        }
+        engine.run();
+        FM_DEBUG("Initial partition attempt ", attempt, ": cut size ", state.getCurrentCutSize());
+        if (state.getCurrentCutSize() < bestCutSize) {
+            bestCutSize = state.getCurrentCutSize();
+            bestPartition = engine.getCellPartitions();
+        }
+    }
+
+    return bestPartition;
+}
+
+const Hypergraph& MultilevelPartitioner::finerGraph(int level) const {
+    return level == 0 ? graph_ : levels_[level - 1].graph;
+}
+
+FMOptions MultilevelPartitioner::fmOptions(int offset, bool coarse) const {
+    FMOptions fmOptions = options_.fmOptions;
+    fmOptions.seed = options_.seed + offset;
+    if (coarse && options_.coarsePasses > 0) {
+        fmOptions.stop.maxPasses = std::min(fmOptions.stop.maxPasses, options_.coarsePasses);
+    }
+    return fmOptions;
+}
+
+} // namespace fm
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "FMEngine.h"
+#include "../DataStructures/Hypergraph.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace fm {
+
+// Tuning knobs for the multilevel partitioner
+struct MultilevelOptions {
+    int coarsestSize = 2000;      // Stop coarsening at or below this many cells
+    int maxLevels = 32;           // Hard limit on the number of coarse levels
+    double minReduction = 0.95;   // Stop once a level keeps more than this fraction of cells
+    double minPinReduction = 0.95; // ...or more than this fraction of pins
+    int largeNetSize = 1000;      // Nets with more pins are ignored when rating neighbors
+    int initialTries = 4;         // Random starts refined on the coarsest level
+    int coarsePasses = 4;         // Pass limit on coarse levels (0 = the FM policy's own)
+    unsigned seed = 1;            // Seed for visit orders and initial partitions
+    FMOptions fmOptions;          // Every FM run; its seed is replaced by the one above
+};
+
+// hMETIS-style V-cycle. The hypergraph is coarsened level by level with
+// first-choice clustering, the coarsest level is partitioned by refining a
+// few random balanced splits with FMEngine, and the best one is projected
+// back up, running FMEngine again on every finer level.
+class MultilevelPartitioner {
+public:
+    // Constructor
+    MultilevelPartitioner(const Hypergraph& graph, double balanceFactor,
+                          const MultilevelOptions& options = MultilevelOptions());
+
+    // Main algorithm method. Throws std::runtime_error if not even a random
+    // split of the input meets the balance window
+    void run();
+
+    // Engine holding the final solution on the input hypergraph (valid after run)
+    const FMEngine& getEngine() const { return *engine_; }
+    int getNumLevels() const { return static_cast<int>(levels_.size()); }
+
+private:
+    struct Level {
+        Hypergraph graph;               // Coarse hypergraph
+        std::vector<int> fineToCoarse;  // Cell of the next finer level -> cell here
+    };
+
+    const Hypergraph& graph_;
+    double balanceFactor_;
+    MultilevelOptions options_;
+    std::vector<Level> levels_;         // levels_[0] is the first coarsening of graph_
+    std::unique_ptr<FMEngine> engine_;
+    std::mt19937 rng_;
+
+    // Phases
+    void coarsen();
+    bool coarsenLevel(const Hypergraph& fine, int maxClusterWeight, Level& level);
+    std::vector<int> partitionCoarsest(const Hypergraph& coarsest);  // Empty if no start balances
+
+    // Helper methods
+    const Hypergraph& finerGraph(int level) const;  // Graph that levels_[level] was built from
+    FMOptions fmOptions(int offset, bool coarse = false) const;  // Seeded with seed + offset; coarse caps passes
+};
+
+} // namespace fm
@@ -0,0 +1,122 @@
+#include "Reorder.h"
+#include <algorithm>
+
+namespace fm {
+
+namespace {
+
+// Appends the cells reachable from start to order; order doubles as the queue
+void growFrom(const Hypergraph& graph, int start, bool byDegree, int maxNetSize,
+              std::vector<int>& order, std::vector<char>& cellSeen, std::vector<char>& netSeen) {
+    size_t head = order.size();
+    cellSeen[start] = 1;
+    order.push_back(start);
+    while (head < order.size()) {
+        int cellId = order[head++];
+        size_t firstNew = order.size();
+        for (int netId : graph.getCellNets(cellId)) {
+            if (netSeen[netId] || graph.getNetSize(netId) > maxNetSize) {
+                continue;
+            }
+            netSeen[netId] = 1;
+            for (int pin : graph.getNetPins(netId)) {
+                if (!cellSeen[pin]) {
+                    cellSeen[pin] = 1;
+                    order.push_back(pin);
+                }
+            }
+        }
+        if (byDegree) {
+            // Cuthill-McKee: this cell's new neighbors, lowest degree first
+            std::stable_sort(order.begin() + firstNew, order.end(), [&graph](int a, int b) {
+                return graph.getCellDegree(a) < graph.getCellDegree(b);
+            });
+        }
+    }
+}
+
+} // namespace
+
+const char* toString(CellOrdering ordering) {
+    switch (ordering) {
+    case CellOrdering::NONE: return "none";
+    case CellOrdering::BFS:  return "bfs";
+    case CellOrdering::RCM:  return "rcm";
+    }
+    return "unknown";
+}
+
+std::vector<int> bfsCellOrder(const Hypergraph& graph, bool byDegree, int maxNetSize) {
+    const int numCells = graph.getNumCells();
+    std::vector<int> order;
+    if (numCells == 0) {
+        return order;
+    }
+    order.reserve(numCells);
+    std::vector<char> cellSeen(numCells, 0);
+    std::vector<char> netSeen(graph.getNumNets(), 0);
+
+    // Start from the last cell a BFS from cell 0 reaches: it sits on the rim
+    // of its component, which keeps the BFS levels narrow
+    growFrom(graph, 0, byDegree, maxNetSize, order, cellSeen, netSeen);
+    int start = order.back();
+    order.clear();
+    std::fill(cellSeen.begin(), cellSeen.end(), 0);
+    std::fill(netSeen.begin(), netSeen.end(), 0);
+
+    growFrom(graph, start, byDegree, maxNetSize, order, cellSeen, netSeen);
+    for (int cellId = 0; cellId < numCells; cellId++) {
+        if (!cellSeen[cellId]) {
+            growFrom(graph, cellId, byDegree, maxNetSize, order, cellSeen, netSeen);
+        }
+    }
+    return order;
+}
+
+Hypergraph reorderHypergraph(const Hypergraph& graph, CellOrdering ordering) {
+    std::vector<int> cellOrder;
+    if (ordering == CellOrdering::NONE) {
+        return graph;
+    } else if (ordering == CellOrdering::RCM) {
+        cellOrder = bfsCellOrder(graph, true);
+        std::reverse(cellOrder.begin(), cellOrder.end());
+    } else {
+        cellOrder = bfsCellOrder(graph, false);
+    }
+
+    // Nets in the order the new cell order first touches them
+    std::vector<int> netOrder;
+    netOrder.reserve(graph.getNumNets());
+    std::vector<char> netSeen(graph.getNumNets(), 0);
+    for (int cellId : cellOrder) {
+        for (int netId : graph.getCellNets(cellId)) {
+            if (!netSeen[netId]) {
+                netSeen[netId] = 1;
+                netOrder.push_back(netId);
+            }
+        }
+    }
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
+        if (!netSeen[netId]) {
+            netOrder.push_back(netId);  // Nets without pins
+        }
+    }
+    return graph.permuted(cellOrder, netOrder);
+}
+
+double meanNetSpan(const Hypergraph& graph) {
+    long long totalSpan = 0;
+    int nets = 0;
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
+        IdSpan pins = graph.getNetPins(netId);
+        if (pins.size() < 2) {
+            continue;
+        }
+        auto range = std::minmax_element(pins.begin(), pins.end());
+        totalSpan += *range.second - *range.first;
+        nets++;
+    }
+    return nets > 0 ? static_cast<double>(totalSpan) / nets : 0.0;
+}
+
+} // namespace fm
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../DataStructures/Hypergraph.h"
+#include <vector>
+
+namespace fm {
+
+// Cell renumbering for memory locality. Cell and net IDs come in
+// first-seen parse order, so the pins of one net are scattered over the
+// per-cell arrays; after renumbering, cells that share nets get nearby IDs.
+enum class CellOrdering {
+    NONE,
+    BFS,  // Breadth-first from a pseudo-peripheral cell
+    RCM   // Reverse Cuthill-McKee: BFS taking neighbors by ascending degree, reversed
+};
+const char* toString(CellOrdering ordering);
+
+// Cells in visit order (new ID -> old ID). Every cell appears once; each
+// net is expanded once, nets above maxNetSize pins are not followed, and
+// further components are started from the lowest unvisited ID.
+std::vector<int> bfsCellOrder(const Hypergraph& graph, bool byDegree, int maxNetSize = 1000);
+
+// Renumbered copy of graph; names travel with their cells and nets, so the
+// output is the same as for the original numbering. Nets are numbered in
+// the order the new cell order first reaches them.
+Hypergraph reorderHypergraph(const Hypergraph& graph, CellOrdering ordering);
+
+// Mean (highest - lowest cell ID) over nets with at least two pins: a proxy
+// for how far apart a net's pin walk reaches in the per-cell arrays
+double meanNetSpan(const Hypergraph& graph);
+
+} // namespace fm
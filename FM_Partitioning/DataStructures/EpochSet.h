@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace fm {
+
+// Set of dense IDs backed by one stamp per ID. An ID is a member when its
+// stamp equals the current epoch, so membership is a single load and
+// clear() just advances the epoch; storage is sized once and reused.
+class EpochSet {
+public:
+    // Size for IDs in [0, size) and empty the set
+    void resize(int size) {
+        stamps_.assign(size, 0);
+        epoch_ = 1;
+    }
+
+    void clear() {
+        if (++epoch_ == 0) {
+            // Epoch wrapped around; old stamps could alias the new epoch
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    bool contains(int id) const { return stamps_[id] == epoch_; }
+
+    // Returns false if id was already a member
+    bool insert(int id) {
+        if (stamps_[id] == epoch_) {
+            return false;
+        }
+        stamps_[id] = epoch_;
+        return true;
+    }
+
+private:
+    std::vector<unsigned> stamps_;
+    unsigned epoch_ = 1;
+};
+
+} // namespace fm
@@ -1,196 +1,218 @@
 #include "GainBucket.h"
 #include "PartitionState.h"
+#include "../Utils/Logger.h"
+#include "../Utils/Stats.h"
+#include <algorithm>
 #include <stdexcept>
-#include <iostream>
 
 namespace fm {
 
-GainBucket::GainBucket(int maxPossibleDegree) 
+GainBucket::GainBucket(int maxPossibleDegree)
     : maxPossibleDegree(maxPossibleDegree) {
     // Initialize bucket lists for both partitions
     // Size is 2*maxPossibleDegree + 1 to accommodate gains from -maxDegree to +maxDegree
     int bucketSize = 2 * maxPossibleDegree + 1;
-    buckets_[0].resize(bucketSize, nullptr);
-    buckets_[1].resize(bucketSize, nullptr);
-}
-
-GainBucket::~GainBucket() {
-    // Clean up all nodes in both partitions
     for (int p = 0; p < 2; p++) {
-        for (auto& head : buckets_[p]) {
-            while (head) {
-                BucketNode* next = head->next;
-                delete head;
-                head = next;
-            }
-        }
+        buckets_[p].resize(bucketSize, -1);
+        tails_[p].resize(bucketSize, -1);
     }
 }
 
-void GainBucket::initialize(const std::vector<Cell>& cells) {
-    std::cout << "Initializing gain buckets..." << std::endl;
-    // Clear existing buckets
+void GainBucket::initialize(const std::vector<int>& cellPartition,
+                            const std::vector<int>& cellGain,
+                            const std::vector<char>& cellLocked) {
+    FM_DEBUG("Initializing gain buckets...");
+    // Clear existing buckets. Nodes are owned by the pool, so only the list
+    // heads need resetting.
     for (int p = 0; p < 2; p++) {
-        for (auto& head : buckets_[p]) {
-            while (head) {
-                BucketNode* next = head->next;
-                delete head;
-                head = next;
-            }
-            head = nullptr;
-        }
+        std::fill(buckets_[p].begin(), buckets_[p].end(), -1);
+        std::fill(tails_[p].begin(), tails_[p].end(), -1);
         maxGain_[p] = -maxPossibleDegree;
+        numCells_[p] = 0;
     }
 
-    // Add all unlocked cells to their respective gain buckets
-    for (const auto& cell : cells) {
-        if (!cell.locked) {
-            addCell(const_cast<Cell*>(&cell));
+    // Size the node pool once; no allocation happens after this point
+    nodePool_.assign(cellPartition.size(), BucketNode());
+
+    // Bulk-link every unlocked cell from its precomputed gain. Cells go in
+    // by ascending ID at the list heads, so the lists match filing them
+    // one by one with addCell, minus its per-call checks and logging.
+    for (int cellId = 0; cellId < static_cast<int>(cellPartition.size()); cellId++) {
+        if (cellLocked[cellId]) {
+            continue;
+        }
+        int partition = cellPartition[cellId];
+        int gain = cellGain[cellId];
+        int& head = buckets_[partition][gainToIndex(gain)];
+        BucketNode& node = nodePool_[cellId];
+        node.gain = gain;
+        node.partition = partition;
+        node.next = head;
+        if (head >= 0) {
+            nodePool_[head].prev = cellId;
+        } else {
+            tails_[partition][gainToIndex(gain)] = cellId;
         }
+        head = cellId;
+        numCells_[partition]++;
+        maxGain_[partition] = std::max(maxGain_[partition], gain);
     }
 
-    std::cout << "Gain buckets initialized. Max gains: ["
-              << maxGain_[0] << ", " << maxGain_[1] << "]" << std::endl;
+    FM_DEBUG("Gain buckets initialized. Max gains: [", maxGain_[0], ", ", maxGain_[1], "]");
 }
 
-void GainBucket::addCell(Cell* cell) {
-    if (!cell) {
-        std::cerr << "addCell: Error - null cell pointer" << std::endl;
+void GainBucket::addCell(int cellId, int partition, int gain) {
+    if (cellId < 0 || cellId >= static_cast<int>(nodePool_.size())) {
+        FM_ERROR("addCell: Error - cell ", cellId, " has no pooled bucket node");
         return;
     }
 
-    if (cell->bucketNodePtr) {
-        std::cerr << "addCell: Warning - cell " << cell->name 
-                  << " already has a bucket node" << std::endl;
-        removeCell(cell);
+    if (nodePool_[cellId].partition >= 0) {
+        FM_WARNING("addCell: Warning - cell ", cellId, " already has a bucket node");
+        removeCell(cellId);
     }
 
-    // Create new node
-    BucketNode* node = createNode(cell);
-    cell->bucketNodePtr = node;
-
     // Get appropriate bucket
-    int index = gainToIndex(cell->gain);
-    int partition = cell->partition;
+    int index = gainToIndex(gain);
 
     if (index < 0 || index >= static_cast<int>(buckets_[partition].size())) {
-        std::cerr << "addCell: Error - invalid gain index " << index 
-                  << " for cell " << cell->name << std::endl;
-        delete node;
-        cell->bucketNodePtr = nullptr;
+        FM_ERROR("addCell: Error - invalid gain index ", index, " for cell ", cellId);
         return;
     }
 
     // Insert at head of list
-    node->next = buckets_[partition][index];
-    if (node->next) {
-        node->next->prev = node;
+    BucketNode& node = nodePool_[cellId];
+    node.gain = gain;
+    node.partition = partition;
+    node.prev = -1;
+    node.next = buckets_[partition][index];
+    if (node.next >= 0) {
+        nodePool_[node.next].prev = cellId;
+    } else {
+        tails_[partition][index] = cellId;
     }
-    buckets_[partition][index] = node;
+    buckets_[partition][index] = cellId;
+    numCells_[partition]++;
 
     // Update max gain if necessary
-    if (cell->gain > maxGain_[partition]) {
-        maxGain_[partition] = cell->gain;
-        std::cout << "  Updated max gain for partition " << partition 
-                  << " to " << maxGain_[partition] << std::endl;
+    if (gain > maxGain_[partition]) {
+        maxGain_[partition] = gain;
+        FM_TRACE("  Updated max gain for partition ", partition, " to ", maxGain_[partition]);
     }
 }
 
-void GainBucket::removeCell(Cell* cell) {
-    if (!cell || !cell->bucketNodePtr) {
+void GainBucket::removeCell(int cellId) {
+    if (cellId < 0 || cellId >= static_cast<int>(nodePool_.size()) ||
+        nodePool_[cellId].partition < 0) {
         return;
     }
 
-    BucketNode* node = cell->bucketNodePtr;
-    int index = gainToIndex(cell->gain);
-    int partition = cell->partition;
-
-    // Update list pointers
-    if (node->prev) {
-        node->prev->next = node->next;
-    } else {
-        buckets_[partition][index] = node->next;
-    }
-    
-    if (node->next) {
-        node->next->prev = node->prev;
-    }
-
-    // Clean up
-    delete node;
-    cell->bucketNodePtr = nullptr;
+    int partition = nodePool_[cellId].partition;
+    int gain = nodePool_[cellId].gain;
+    unlinkNode(cellId);
 
     // Update max gain if necessary
-    if (cell->gain == maxGain_[partition]) {
+    if (gain == maxGain_[partition]) {
         updateMaxGain(partition);
     }
 }
 
-void GainBucket::updateCellGain(Cell* cell, int oldGain, int newGain) {
-    if (!cell) {
-        std::cerr << "updateCellGain: Error - null cell pointer" << std::endl;
+void GainBucket::updateCellGain(int cellId, int oldGain, int newGain) {
+    if (cellId < 0 || cellId >= static_cast<int>(nodePool_.size()) ||
+        nodePool_[cellId].partition < 0) {
+        FM_ERROR("updateCellGain: Error - cell ", cellId, " is not in a bucket");
         return;
     }
 
-    std::cout << "Updating gain for cell " << cell->name 
-              << " from " << oldGain << " to " << newGain << std::endl;
+    FM_TRACE("Updating gain for cell ", cellId, " from ", oldGain, " to ", newGain);
+    FM_STAT(updateCount_++);
+
+    // Relink into the new bucket on the same side. addCell raises the max
+    // gain if needed; the max only has to be searched for when the cell
+    // left the top bucket empty.
+    int partition = nodePool_[cellId].partition;
+    int filedGain = nodePool_[cellId].gain;
+    unlinkNode(cellId);
+    addCell(cellId, partition, newGain);
+    if (filedGain == maxGain_[partition]) {
+        updateMaxGain(partition);
+    }
+}
 
-    // Remove from old bucket
-    removeCell(cell);
+void GainBucket::setTieBreak(TieBreak tieBreak, unsigned seed) {
+    tieBreak_ = tieBreak;
+    rng_.seed(seed);
+}
 
-    // Update cell's gain
-    cell->gain = newGain;
+int GainBucket::getBestFeasibleCell(const PartitionState& state,
+                                    const std::vector<int>& cellWeights) {
+    int cell0 = getBestCellFromSide(0, state, cellWeights);
+    int cell1 = getBestCellFromSide(1, state, cellWeights);
+    if (cell0 < 0 || cell1 < 0) {
+        return cell0 < 0 ? cell1 : cell0;
+    }
 
-    // Add to new bucket
-    addCell(cell);
+    int gain0 = nodePool_[cell0].gain;
+    int gain1 = nodePool_[cell1].gain;
+    if (gain0 != gain1) {
+        return gain0 > gain1 ? cell0 : cell1;
+    }
 
-    // Update max gain if necessary
-    if (newGain > maxGain_[cell->partition]) {
-        maxGain_[cell->partition] = newGain;
-        std::cout << "  Updated max gain for partition " << cell->partition 
-                  << " to " << maxGain_[cell->partition] << std::endl;
+    // Equal gains: moving off the heavier side keeps more slack for later moves
+    if (tieBreak_ == TieBreak::RANDOM) {
+        return (rng_() & 1) ? cell1 : cell0;
     }
+    return state.getPartitionSize(1) > state.getPartitionSize(0) ? cell1 : cell0;
 }
 
-Cell* GainBucket::getBestFeasibleCell(const PartitionState& state) {
-    // Try both partitions
-    for (int p = 0; p < 2; p++) {
-        // Start from maximum gain and work down
-        for (int gain = maxGain_[p]; gain >= -maxPossibleDegree; gain--) {
-            int index = gainToIndex(gain);
-            if (index < 0 || index >= static_cast<int>(buckets_[p].size())) {
-                continue;
-            }
+int GainBucket::getBestCellFromSide(int partition, const PartitionState& state,
+                                    const std::vector<int>& cellWeights) {
+    if (numCells_[partition] == 0) {
+        return -1;
+    }
+
+    int otherPartition = 1 - partition;
+    int fromSize = state.getPartitionSize(partition);
+    int toSize = state.getPartitionSize(otherPartition);
+
+    int cellId = pickFromBucket(partition, gainToIndex(maxGain_[partition]));
+    FM_STAT(scanCount_++);
+    if (state.isBalanced(fromSize - cellWeights[cellId], toSize + cellWeights[cellId])) {
+        FM_TRACE("Found feasible cell ", cellId, " with gain ", maxGain_[partition]);
+        return cellId;
+    }
 
-            BucketNode* node = buckets_[p][index];
-            while (node) {
-                Cell* cell = node->cellPtr;
-                if (!cell) {
-                    std::cerr << "getBestFeasibleCell: Error - found null cell pointer" << std::endl;
-                    node = node->next;
-                    continue;
-                }
-
-                if (cell->locked) {
-                    node = node->next;
-                    continue;
-                }
-
-                // Check if moving this cell maintains balance
-                int otherPartition = 1 - p;
-                int newSize1 = state.getPartitionSize(p) - 1;
-                int newSize2 = state.getPartitionSize(otherPartition) + 1;
-                
-                if (state.isBalanced(newSize1, newSize2)) {
-                    std::cout << "Found feasible cell " << cell->name 
-                              << " with gain " << cell->gain << std::endl;
-                    return cell;
-                }
-                node = node->next;
+    // Balance depends only on the side and the cell weight. If not even a
+    // unit-weight cell may leave, the side is closed; with unit weights
+    // (every parsed netlist) that is always the case here.
+    if (!state.isBalanced(fromSize - 1, toSize + 1)) {
+        return -1;
+    }
+
+    // Weighted (coarsened) graph: a lighter cell further down may still fit
+    for (int gain = maxGain_[partition]; gain >= -maxPossibleDegree; gain--) {
+        for (cellId = buckets_[partition][gainToIndex(gain)]; cellId >= 0;
+             cellId = nodePool_[cellId].next) {
+            FM_STAT(scanCount_++);
+            if (state.isBalanced(fromSize - cellWeights[cellId], toSize + cellWeights[cellId])) {
+                FM_TRACE("Found feasible cell ", cellId, " with gain ", gain);
+                return cellId;
             }
         }
     }
-    return nullptr;
+    return -1;
+}
+
+int GainBucket::pickFromBucket(int partition, int index) {
+    switch (tieBreak_) {
+    case TieBreak::FIFO:
+        return tails_[partition][index];
+    case TieBreak::RANDOM:
+        return (rng_() & 1) ? tails_[partition][index] : buckets_[partition][index];
+    case TieBreak::LIFO:
+    default:
+        return buckets_[partition][index];
+    }
 }
 
 int GainBucket::gainToIndex(int gain) const {
@@ -198,24 +220,40 @@ int GainBucket::gainToIndex(int gain) const {
 }
 
 void GainBucket::updateMaxGain(int partition) {
-    maxGain_[partition] = -maxPossibleDegree;
-    
-    // Scan buckets from high to low to find new max gain
-    for (int gain = maxPossibleDegree; gain >= -maxPossibleDegree; gain--) {
-        int index = gainToIndex(gain);
-        if (buckets_[partition][index] != nullptr) {
-            maxGain_[partition] = gain;
-            break;
-        }
+    if (numCells_[partition] == 0) {
+        maxGain_[partition] = -maxPossibleDegree;
+        return;
+    }
+
+    // maxGain_ is never below the true maximum (addCell raises it, removals
+    // only lower it), so scan down from it rather than from +maxPossibleDegree
+    int gain = maxGain_[partition];
+    while (buckets_[partition][gainToIndex(gain)] < 0) {
+        gain--;
     }
+    maxGain_[partition] = gain;
 }
 
-BucketNode* GainBucket::createNode(Cell* cell) {
-    BucketNode* node = new BucketNode();
-    node->cellPtr = cell;
-    node->prev = nullptr;
-    node->next = nullptr;
-    return node;
+void GainBucket::unlinkNode(int cellId) {
+    BucketNode& node = nodePool_[cellId];
+
+    // Update list pointers
+    if (node.prev >= 0) {
+        nodePool_[node.prev].next = node.next;
+    } else {
+        buckets_[node.partition][gainToIndex(node.gain)] = node.next;
+    }
+
+    if (node.next >= 0) {
+        nodePool_[node.next].prev = node.prev;
+    } else {
+        tails_[node.partition][gainToIndex(node.gain)] = node.prev;
+    }
+    numCells_[node.partition]--;
+
+    node.prev = -1;
+    node.next = -1;
+    node.partition = -1;
 }
 
-} // namespace fm 
\ No newline at end of file
+} // namespace fm
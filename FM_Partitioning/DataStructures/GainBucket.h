@@ -1,41 +1,74 @@
 #pragma once
 
+#include <random>
 #include <vector>
-#include "Netlist.h"
 #include "PartitionState.h"
 
 namespace fm {
 
+// Bucket list links for one cell. Nodes live in a pool owned by GainBucket and
+// indexed by cell id, so moving a cell between buckets is a pure relink.
 struct BucketNode {
-    Cell* cellPtr = nullptr;    // Pointer back to the cell
-    BucketNode *prev = nullptr, *next = nullptr;
+    int prev = -1, next = -1;   // Neighbouring cell IDs in the same list (-1 = none)
+    int gain = 0;               // Gain the cell is currently filed under
+    int partition = -1;         // Side the cell is filed under, -1 when not in a bucket
+};
+
+// Which cell to take among equal-gain candidates. Within a bucket LIFO takes
+// the most recently filed cell and FIFO the oldest; RANDOM picks either end
+// at random. Between the two sides, equal gains go to the heavier side
+// (RANDOM: a random side).
+enum class TieBreak {
+    LIFO,
+    FIFO,
+    RANDOM
 };
 
 class GainBucket {
 public:
-    // Constructor/Destructor
+    // Constructor
     GainBucket(int maxPossibleDegree);
-    ~GainBucket();
-
-    // Bucket operations
-    void initialize(const std::vector<Cell>& cells);
-    void addCell(Cell* cell);
-    void removeCell(Cell* cell);
-    void updateCellGain(Cell* cell, int oldGain, int newGain);
-    Cell* getBestFeasibleCell(const PartitionState& state);
-    
+
+    // Bucket operations. initialize bulk-builds the lists from precomputed
+    // gains of every unlocked cell.
+    void initialize(const std::vector<int>& cellPartition,
+                    const std::vector<int>& cellGain,
+                    const std::vector<char>& cellLocked);
+    void addCell(int cellId, int partition, int gain);
+    void removeCell(int cellId);
+    void updateCellGain(int cellId, int oldGain, int newGain);
+    int getBestFeasibleCell(const PartitionState& state,
+                            const std::vector<int>& cellWeights);  // -1 if none
+    void setTieBreak(TieBreak tieBreak, unsigned seed = 1);
+
     // Accessors
     int getMaxGain(int partition) const { return maxGain_[partition]; }
+    bool contains(int cellId) const { return nodePool_[cellId].partition >= 0; }
+    int getNumCells(int partition) const { return numCells_[partition]; }
+
+    // Instrumentation (see Utils/Stats.h); running totals, never reset
+    long long getUpdateCount() const { return updateCount_; }
+    long long getScanCount() const { return scanCount_; }  // Cells examined by getBestFeasibleCell
 
 private:
-    std::vector<BucketNode*> buckets_[2];  // Array of lists for G1 and G2
-    int maxGain_[2] = {0, 0};              // Tracks highest gain in each partition
+    std::vector<int> buckets_[2];          // List heads (cell IDs) for G1 and G2
+    std::vector<int> tails_[2];            // List tails, for FIFO selection
+    std::vector<BucketNode> nodePool_;     // One node per cell, indexed by cell id
+    int maxGain_[2] = {0, 0};              // Upper bound on the highest gain; exact while non-empty
+    int numCells_[2] = {0, 0};             // Cells filed on each side
     int maxPossibleDegree;                 // Maximum possible degree (for gain indexing)
-    
+    TieBreak tieBreak_ = TieBreak::LIFO;
+    std::mt19937 rng_;                     // Used by TieBreak::RANDOM only
+    long long updateCount_ = 0;            // updateCellGain calls
+    long long scanCount_ = 0;              // Candidates checked for balance
+
     // Helper methods
     int gainToIndex(int gain) const;
     void updateMaxGain(int partition);
-    BucketNode* createNode(Cell* cell);
+    void unlinkNode(int cellId);
+    int pickFromBucket(int partition, int index);
+    int getBestCellFromSide(int partition, const PartitionState& state,
+                            const std::vector<int>& cellWeights);
 };
 
-} // namespace fm 
\ No newline at end of file
+} // namespace fm
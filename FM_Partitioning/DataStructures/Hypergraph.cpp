@@ -0,0 +1,118 @@
+#include "Hypergraph.h"
+#include <algorithm>
+#include <utility>
+
+namespace fm {
+
+Hypergraph::Hypergraph(const Netlist& netlist) {
+    const std::vector<Cell>& cells = netlist.getCells();
+    const std::vector<Net>& nets = netlist.getNets();
+
+    // Net -> pin offsets and pins, preserving the parsed pin order
+    netPinOffsets_.reserve(nets.size() + 1);
+    netNames_.reserve(nets.size());
+    netWeights_.reserve(nets.size());
+    size_t totalPins = 0;
+    for (const auto& net : nets) {
+        totalPins += net.cellIds.size();
+    }
+    netPins_.reserve(totalPins);
+    for (const auto& net : nets) {
+        netPins_.insert(netPins_.end(), net.cellIds.begin(), net.cellIds.end());
+        netPinOffsets_.push_back(static_cast<int>(netPins_.size()));
+        netNames_.push_back(net.name);
+        netWeights_.push_back(net.weight);
+    }
+
+    // Cell -> net offsets and nets
+    cellNetOffsets_.reserve(cells.size() + 1);
+    cellNames_.reserve(cells.size());
+    cellNets_.reserve(totalPins);
+    for (const auto& cell : cells) {
+        cellNets_.insert(cellNets_.end(), cell.netIds.begin(), cell.netIds.end());
+        cellNetOffsets_.push_back(static_cast<int>(cellNets_.size()));
+        cellNames_.push_back(cell.name);
+        maxCellDegree_ = std::max(maxCellDegree_, static_cast<int>(cell.netIds.size()));
+    }
+
+    // Parsed cells all count as one
+    cellWeights_.assign(cells.size(), 1);
+    totalCellWeight_ = static_cast<int>(cells.size());
+}
+
+Hypergraph::Hypergraph(std::vector<int> netPinOffsets, std::vector<int> netPins,
+                       std::vector<int> cellWeights, std::vector<int> netWeights)
+    : netPinOffsets_(std::move(netPinOffsets))
+    , netPins_(std::move(netPins))
+    , cellWeights_(std::move(cellWeights))
+    , netWeights_(std::move(netWeights)) {
+    const int numCells = static_cast<int>(cellWeights_.size());
+    const int numNets = getNumNets();
+    if (netWeights_.empty()) {
+        netWeights_.assign(numNets, 1);
+    }
+
+    // Count pins per cell, then fill cell -> net lists in net order
+    cellNetOffsets_.assign(numCells + 1, 0);
+    for (int cellId : netPins_) {
+        cellNetOffsets_[cellId + 1]++;
+    }
+    for (int cellId = 0; cellId < numCells; cellId++) {
+        maxCellDegree_ = std::max(maxCellDegree_, cellNetOffsets_[cellId + 1]);
+        cellNetOffsets_[cellId + 1] += cellNetOffsets_[cellId];
+    }
+    cellNets_.resize(netPins_.size());
+    std::vector<int> cursor(cellNetOffsets_.begin(), cellNetOffsets_.end() - 1);
+    for (int netId = 0; netId < numNets; netId++) {
+        for (int cellId : getNetPins(netId)) {
+            cellNets_[cursor[cellId]++] = netId;
+        }
+    }
+
+    for (int weight : cellWeights_) {
+        totalCellWeight_ += weight;
+    }
+}
+
+Hypergraph Hypergraph::permuted(const std::vector<int>& cellOrder,
+                                const std::vector<int>& netOrder) const {
+    std::vector<int> newCellId(getNumCells());
+    for (int newId = 0; newId < getNumCells(); newId++) {
+        newCellId[cellOrder[newId]] = newId;
+    }
+
+    std::vector<int> netPinOffsets(1, 0);
+    netPinOffsets.reserve(getNumNets() + 1);
+    std::vector<int> netPins;
+    netPins.reserve(netPins_.size());
+    std::vector<int> netWeights;
+    netWeights.reserve(getNumNets());
+    for (int netId : netOrder) {
+        for (int cellId : getNetPins(netId)) {
+            netPins.push_back(newCellId[cellId]);
+        }
+        netPinOffsets.push_back(static_cast<int>(netPins.size()));
+        netWeights.push_back(netWeights_[netId]);
+    }
+    std::vector<int> cellWeights;
+    cellWeights.reserve(getNumCells());
+    for (int cellId : cellOrder) {
+        cellWeights.push_back(cellWeights_[cellId]);
+    }
+
+    Hypergraph result(std::move(netPinOffsets), std::move(netPins), std::move(cellWeights),
+                      std::move(netWeights));
+    if (hasNames()) {
+        result.cellNames_.reserve(getNumCells());
+        for (int cellId : cellOrder) {
+            result.cellNames_.push_back(cellNames_[cellId]);
+        }
+        result.netNames_.reserve(getNumNets());
+        for (int netId : netOrder) {
+            result.netNames_.push_back(netNames_[netId]);
+        }
+    }
+    return result;
+}
+
+} // namespace fm
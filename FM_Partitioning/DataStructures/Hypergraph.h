@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Netlist.h"
+
+namespace fm {
+
+// Contiguous run of cell or net IDs inside one of the CSR arrays
+struct IdSpan {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+};
+
+// Compact, read-only hypergraph built once from a parsed Netlist.
+// Connectivity is stored in compressed-sparse-row form:
+//   pins of net n  -> netPins_[netPinOffsets_[n] .. netPinOffsets_[n + 1])
+//   nets of cell c -> cellNets_[cellNetOffsets_[c] .. cellNetOffsets_[c + 1])
+// Cell and net IDs match the Netlist they were built from. Names live in a
+// side table that is only needed when writing results.
+// Cells carry an integer weight (1 for parsed netlists) so that coarsened
+// graphs, whose cells stand for clusters, can reuse the same engine. Nets
+// carry the cost of cutting them (1 unless the input gives one).
+class Hypergraph {
+public:
+    // Constructors
+    Hypergraph() = default;
+    explicit Hypergraph(const Netlist& netlist);
+    // Unnamed graph from net->pin CSR arrays; the cell->net side is derived.
+    // Empty netWeights means every net weighs 1.
+    Hypergraph(std::vector<int> netPinOffsets, std::vector<int> netPins,
+               std::vector<int> cellWeights, std::vector<int> netWeights = {});
+
+    // Copy with cells and nets renumbered: new cell i is old cell
+    // cellOrder[i], new net j is old net netOrder[j]. Weights, names and the
+    // pin order within each net travel along.
+    Hypergraph permuted(const std::vector<int>& cellOrder, const std::vector<int>& netOrder) const;
+
+    // Sizes
+    int getNumCells() const { return static_cast<int>(cellNetOffsets_.size()) - 1; }
+    int getNumNets() const { return static_cast<int>(netPinOffsets_.size()) - 1; }
+    int getNumPins() const { return static_cast<int>(netPins_.size()); }
+    int getMaxCellDegree() const { return maxCellDegree_; }
+
+    // Cell weights
+    int getCellWeight(int cellId) const { return cellWeights_[cellId]; }
+    const std::vector<int>& getCellWeights() const { return cellWeights_; }
+    int getTotalCellWeight() const { return totalCellWeight_; }
+
+    // Net weights
+    int getNetWeight(int netId) const { return netWeights_[netId]; }
+    const std::vector<int>& getNetWeights() const { return netWeights_; }
+
+    // Adjacency (no bounds checks; IDs must be valid)
+    IdSpan getNetPins(int netId) const {
+        return {netPins_.data() + netPinOffsets_[netId], netPins_.data() + netPinOffsets_[netId + 1]};
+    }
+    IdSpan getCellNets(int cellId) const {
+        return {cellNets_.data() + cellNetOffsets_[cellId], cellNets_.data() + cellNetOffsets_[cellId + 1]};
+    }
+    int getNetSize(int netId) const { return netPinOffsets_[netId + 1] - netPinOffsets_[netId]; }
+    int getCellDegree(int cellId) const { return cellNetOffsets_[cellId + 1] - cellNetOffsets_[cellId]; }
+
+    // Name side table (empty for coarsened graphs)
+    bool hasNames() const { return !cellNames_.empty(); }
+    const std::string& getCellName(int cellId) const { return cellNames_[cellId]; }
+    const std::string& getNetName(int netId) const { return netNames_[netId]; }
+
+private:
+    friend class Snapshot;  // Writes and loads the arrays below as-is
+
+    std::vector<int> netPinOffsets_ = {0};   // Size numNets + 1
+    std::vector<int> netPins_;               // Cell IDs, grouped by net
+    std::vector<int> cellNetOffsets_ = {0};  // Size numCells + 1
+    std::vector<int> cellNets_;              // Net IDs, grouped by cell
+    int maxCellDegree_ = 0;
+    std::vector<int> cellWeights_;
+    int totalCellWeight_ = 0;
+    std::vector<int> netWeights_;
+
+    std::vector<std::string> cellNames_;
+    std::vector<std::string> netNames_;
+};
+
+} // namespace fm
@@ -1,15 +1,18 @@
 #include "Netlist.h"
 #include <stdexcept>
 #include <iostream>
+#include <utility>
 
 namespace fm {
 
-void Netlist::addCell(const std::string& name) {
+int Netlist::addCell(const std::string& name) {
     // std::cout << "Adding cell: " << name << std::endl; // Reduced logging
     // Check if cell already exists
-    if (cellNameToId_.find(name) != cellNameToId_.end()) {
+    indexCellNames();
+    auto it = cellNameToId_.find(name);
+    if (it != cellNameToId_.end()) {
         // std::cout << "  Cell already exists" << std::endl; // Reduced logging
-        return;  // Cell already exists
+        return it->second;  // Cell already exists
     }
 
     // Create new cell
@@ -20,10 +23,27 @@ void Netlist::addCell(const std::string& name) {
     // Add to containers
     cells_.push_back(cell);
     cellNameToId_[name] = cell.id;
+    indexedCells_ = static_cast<int>(cells_.size());
     // std::cout << "  Cell added with ID: " << cell.id << std::endl; // Reduced logging
+    return cell.id;
+}
+
+int Netlist::appendCell(std::string name) {
+    Cell cell;
+    cell.name = std::move(name);
+    cell.id = static_cast<int>(cells_.size());
+    cells_.push_back(std::move(cell));
+    return cells_.back().id;
+}
+
+void Netlist::indexCellNames() {
+    for (; indexedCells_ < static_cast<int>(cells_.size()); indexedCells_++) {
+        cellNameToId_.emplace(cells_[indexedCells_].name, indexedCells_);
+    }
 }
 
 Cell* Netlist::getCellByName(const std::string& name) {
+    indexCellNames();
     auto it = cellNameToId_.find(name);
     if (it == cellNameToId_.end()) {
         return nullptr;
@@ -46,24 +66,41 @@ const Cell* Netlist::getCellById(int id) const {
     return &cells_[id]; // Return const pointer
 }
 
-void Netlist::addNet(const std::string& name) {
+int Netlist::addNet(const std::string& name) {
     // std::cout << "Adding net: " << name << std::endl; // Reduced logging
     // Check if net already exists
-    if (netNameToId_.find(name) != netNameToId_.end()) {
+    indexNetNames();
+    auto it = netNameToId_.find(name);
+    if (it != netNameToId_.end()) {
         // std::cout << "  Net already exists" << std::endl; // Reduced logging
-        return;  // Net already exists
+        return it->second;  // Net already exists
     }
 
     // Create new net
     Net net;
     net.name = name;
     net.id = static_cast<int>(nets_.size());
-    net.partitionCount[0] = net.partitionCount[1] = 0;  // Initialize partition counts
     
     // Add to containers
     nets_.push_back(net);
     netNameToId_[name] = net.id;
+    indexedNets_ = static_cast<int>(nets_.size());
     // std::cout << "  Net added with ID: " << net.id << std::endl; // Reduced logging
+    return net.id;
+}
+
+int Netlist::appendNet(std::string name) {
+    Net net;
+    net.name = std::move(name);
+    net.id = static_cast<int>(nets_.size());
+    nets_.push_back(std::move(net));
+    return nets_.back().id;
+}
+
+void Netlist::indexNetNames() {
+    for (; indexedNets_ < static_cast<int>(nets_.size()); indexedNets_++) {
+        netNameToId_.emplace(nets_[indexedNets_].name, indexedNets_);
+    }
 }
 
 void Netlist::addCellToNet(const std::string& netName, const std::string& cellName) {
@@ -77,10 +114,18 @@ void Netlist::addCellToNet(const std::string& netName, const std::string& cellNa
         throw std::runtime_error("Net or cell not found when adding cell to net");
     }
 
+    addCellToNet(net->id, cell->id);
+}
+
+void Netlist::addCellToNet(int netId, int cellId) {
+    Net* net = getNetById(netId);
+    Cell* cell = getCellById(cellId);
+
+    if (!net || !cell) {
+        throw std::runtime_error("Net or cell not found when adding cell to net");
+    }
+
     // Check if relationship already exists
-    // Using IDs now
-    int netId = net->id;
-    int cellId = cell->id;
 
     bool cellHasNetId = false;
     for (int existingNetId : cell->netIds) {
@@ -123,7 +168,60 @@ void Netlist::addCellToNet(const std::string& netName, const std::string& cellNa
     // std::cout << "  Cell now has " << cell->netIds.size() << " net IDs" << std::endl; // Reduced logging
 }
 
+void Netlist::addPins(const std::vector<Pin>& pins) {
+    const int numNets = static_cast<int>(nets_.size());
+    const int numCells = static_cast<int>(cells_.size());
+    for (const Pin& pin : pins) {
+        if (pin.netId < 0 || pin.netId >= numNets || pin.cellId < 0 || pin.cellId >= numCells) {
+            throw std::runtime_error("Net or cell not found when adding cell to net");
+        }
+    }
+
+    // Group pin indices by net (stable counting sort) so duplicates of a
+    // net's pins, including ones already in the netlist, can be found with
+    // a per-cell stamp instead of a scan of the adjacency lists.
+    std::vector<int> netStart(numNets + 1, 0);
+    for (const Pin& pin : pins) {
+        netStart[pin.netId + 1]++;
+    }
+    for (int netId = 0; netId < numNets; netId++) {
+        netStart[netId + 1] += netStart[netId];
+    }
+    std::vector<int> byNet(pins.size());
+    std::vector<int> cursor(netStart.begin(), netStart.end() - 1);
+    for (int i = 0; i < static_cast<int>(pins.size()); i++) {
+        byNet[cursor[pins[i].netId]++] = i;
+    }
+
+    std::vector<char> keep(pins.size(), 0);
+    std::vector<int> stamp(numCells, -1);  // Last net that saw each cell
+    for (int netId = 0; netId < numNets; netId++) {
+        if (netStart[netId] == netStart[netId + 1]) {
+            continue;
+        }
+        for (int cellId : nets_[netId].cellIds) {
+            stamp[cellId] = netId;
+        }
+        for (int k = netStart[netId]; k < netStart[netId + 1]; k++) {
+            int cellId = pins[byNet[k]].cellId;
+            if (stamp[cellId] != netId) {
+                stamp[cellId] = netId;
+                keep[byNet[k]] = 1;
+            }
+        }
+    }
+
+    // Append in input order so both adjacency lists match the per-call path
+    for (int i = 0; i < static_cast<int>(pins.size()); i++) {
+        if (keep[i]) {
+            nets_[pins[i].netId].cellIds.push_back(pins[i].cellId);
+            cells_[pins[i].cellId].netIds.push_back(pins[i].netId);
+        }
+    }
+}
+
 Net* Netlist::getNetByName(const std::string& name) {
+    indexNetNames();
     auto it = netNameToId_.find(name);
     if (it == netNameToId_.end()) {
         return nullptr;
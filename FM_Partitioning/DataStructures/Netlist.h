@@ -6,25 +6,25 @@
 
 namespace fm {
 
-// Forward declarations
-struct Net;
-struct BucketNode;
-
+// Parse-time representation. Partitioning state (partition, gain, lock,
+// per-net partition counts) lives in FMEngine over a Hypergraph built from this.
 struct Cell {
     std::string name;
     int id;                     // Unique integer ID
-    int partition = 0;          // e.g., 0 for G1, 1 for G2
-    int gain = 0;
-    bool locked = false;
     std::vector<int> netIds;    // IDs of connected nets
-    BucketNode* bucketNodePtr = nullptr; // Pointer to node in GainBucket's linked list
 };
 
 struct Net {
     std::string name;
     int id;                     // Unique integer ID
+    int weight = 1;             // Cost of cutting the net ("NET name [w] ..." in the input)
     std::vector<int> cellIds;   // IDs of connected cells
-    int partitionCount[2] = {0, 0}; // Count of cells in G1 (index 0) and G2 (index 1)
+};
+
+// One (net, cell) connection, as collected by bulk builders such as the parser
+struct Pin {
+    int netId;
+    int cellId;
 };
 
 class Netlist {
@@ -34,14 +34,19 @@ public:
     ~Netlist() = default;
 
     // Cell management
-    void addCell(const std::string& name);
+    int addCell(const std::string& name);  // Returns the cell ID (existing or new)
+    int appendCell(std::string name);      // Returns the new ID; name must not exist yet
     Cell* getCellByName(const std::string& name);
     Cell* getCellById(int id);
     const Cell* getCellById(int id) const;
 
     // Net management
-    void addNet(const std::string& name);
+    int addNet(const std::string& name);   // Returns the net ID (existing or new)
+    int appendNet(std::string name);       // Returns the new ID; name must not exist yet
     void addCellToNet(const std::string& netName, const std::string& cellName);
+    void addCellToNet(int netId, int cellId);
+    // Bulk equivalent of calling addCellToNet for each pin in order, in O(pins)
+    void addPins(const std::vector<Pin>& pins);
     Net* getNetByName(const std::string& name);
     Net* getNetById(int id);
     const Net* getNetById(int id) const;
@@ -49,12 +54,20 @@ public:
     // Accessors
     const std::vector<Cell>& getCells() const { return cells_; }
     std::vector<Net>& getNets() { return nets_; }
+    const std::vector<Net>& getNets() const { return nets_; }
 
 private:
     std::vector<Cell> cells_;
     std::vector<Net> nets_;
+    // Name indexes. Names added by appendCell/appendNet (the parser interns
+    // them itself) are only hashed here once a by-name lookup needs them.
     std::unordered_map<std::string, int> cellNameToId_;
     std::unordered_map<std::string, int> netNameToId_;
+    int indexedCells_ = 0;
+    int indexedNets_ = 0;
+
+    void indexCellNames();
+    void indexNetNames();
 };
 
 } // namespace fm 
\ No newline at end of file
@@ -21,10 +21,17 @@ void PartitionState::calculateBalanceLimits() {
     // Calculate minimum and maximum partition sizes based on balance factor
     // For n cells and balance factor r:
     // n*(1-r)/2 ≤ |G1|,|G2| ≤ n*(1+r)/2
-    
-    double halfSize = totalCells / 2.0;
-    minPartitionSize = static_cast<int>(std::ceil(halfSize * (1.0 - balanceFactor)));
-    maxPartitionSize = static_cast<int>(std::floor(halfSize * (1.0 + balanceFactor)));
+    std::pair<int, int> limits = blockLimits(totalCells, 2, balanceFactor);
+    minPartitionSize = limits.first;
+    maxPartitionSize = limits.second;
+}
+
+std::pair<int, int> PartitionState::blockLimits(int totalWeight, int numBlocks, double balanceFactor) {
+    // For total weight W, k blocks and balance factor r:
+    // W*(1-r)/k ≤ |block| ≤ W*(1+r)/k
+    double blockSize = static_cast<double>(totalWeight) / numBlocks;
+    return {static_cast<int>(std::ceil(blockSize * (1.0 - balanceFactor))),
+            static_cast<int>(std::floor(blockSize * (1.0 + balanceFactor)))};
 }
 
 void PartitionState::setCurrentCutSize(int cutSize) {
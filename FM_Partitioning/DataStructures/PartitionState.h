@@ -1,10 +1,13 @@
 #pragma once
 
+#include <utility>
+
 namespace fm {
 
 class PartitionState {
 public:
-    // Constructor
+    // Constructor. Sizes are total cell weight, which is the cell count for
+    // unit-weight (parsed) hypergraphs.
     PartitionState(int totalCells, double balanceFactor);
 
     // State management
@@ -23,11 +26,14 @@ public:
     void updateCutSize(int change) { currentCutsize_ += change; }
     void setCurrentCutSize(int cutSize);
 
+    // Balance window {min, max} for each of numBlocks equal blocks
+    static std::pair<int, int> blockLimits(int totalWeight, int numBlocks, double balanceFactor);
+
 private:
-    int partitionSize[2] = {0, 0};  // Current number of cells in G1 and G2
+    int partitionSize[2] = {0, 0};  // Current weight of G1 and G2
     int currentCutsize_ = 0;         // Current cut size
     double balanceFactor;           // The required r
-    int totalCells;                 // Total number of cells n
+    int totalCells;                 // Total cell weight n
     int minPartitionSize;           // Pre-calculated balance limits
     int maxPartitionSize;           // Pre-calculated balance limits
 
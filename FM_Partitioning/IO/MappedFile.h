@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fm {
+
+// Read-only memory mapping of a whole file (POSIX mmap). The mapping is
+// released when the object is destroyed; views into it must not outlive it.
+class MappedFile {
+public:
+    // Constructor/Destructor
+    explicit MappedFile(const std::string& filename);  // Throws on failure
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Accessors
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace fm
@@ -1,54 +1,116 @@
 #include "OutputGenerator.h"
-#include <fstream>
 #include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace fm {
 
+namespace {
+
+// write() until everything is out; a regular file normally takes it in one call
+bool writeAll(int fd, const std::string& buffer) {
+    const char* data = buffer.data();
+    size_t remaining = buffer.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
 bool OutputGenerator::generateOutput(const std::string& filename,
-                                  const Netlist& netlist,
+                                  const Hypergraph& graph,
+                                  const std::vector<int>& cellPartitions,
                                   const PartitionState& state) {
-    std::ofstream file(filename);
-    if (!file) {
-        return false;
-    }
+    // Cut size, then G1 and G2
+    return writeBlocks(filename, graph, cellPartitions, 2, "Cutsize", state.getCurrentCutSize());
+}
 
-    // Write cut size
-    writeCutSize(file, state.getCurrentCutSize());
+bool OutputGenerator::generateOutput(const std::string& filename,
+                                  const Hypergraph& graph,
+                                  const std::vector<int>& cellBlocks,
+                                  int numBlocks, const std::string& objectiveName,
+                                  int objectiveValue) {
+    return writeBlocks(filename, graph, cellBlocks, numBlocks, objectiveName, objectiveValue);
+}
 
-    // Write G1 partition
-    writePartition(file, netlist, 0, "G1");
+bool OutputGenerator::writeBlocks(const std::string& filename, const Hypergraph& graph,
+                                  const std::vector<int>& cellBlocks, int numBlocks,
+                                  const std::string& objectiveName, int objectiveValue) {
+    // Size every block's buffer up front so appending never reallocates
+    std::vector<int> blockCells(numBlocks, 0);
+    std::vector<size_t> blockBytes(numBlocks, 0);
+    for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+        blockCells[cellBlocks[cellId]]++;
+        blockBytes[cellBlocks[cellId]] += graph.getCellName(cellId).size() + 1;
+    }
 
-    // Write G2 partition
-    writePartition(file, netlist, 1, "G2");
+    // Header line and "Gk <count>" prefixes
+    std::vector<std::string> blocks(numBlocks);
+    for (int block = 0; block < numBlocks; block++) {
+        blocks[block] = "G" + std::to_string(block + 1) + " " + std::to_string(blockCells[block]);
+        blocks[block].reserve(blocks[block].size() + blockBytes[block] + 3);
+    }
 
-    return true;
-}
+    // One pass in name order fills all blocks, each sorted for consistent output
+    for (int cellId : cellsByName(graph)) {
+        std::string& buffer = blocks[cellBlocks[cellId]];
+        buffer += ' ';
+        buffer += graph.getCellName(cellId);
+    }
 
-void OutputGenerator::writeCutSize(std::ostream& out, int cutSize) {
-    out << "Cutsize = " << cutSize << "\n";
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, objectiveName + " = " + std::to_string(objectiveValue) + "\n");
+    for (std::string& buffer : blocks) {
+        buffer += " ;\n";
+        ok = ok && writeAll(fd, buffer);
+    }
+    return ::close(fd) == 0 && ok;
 }
 
-void OutputGenerator::writePartition(std::ostream& out, const Netlist& netlist,
-                                   int partitionId, const std::string& label) {
-    // Collect cells in this partition
-    std::vector<std::string> cellNames;
-    for (const auto& cell : netlist.getCells()) {
-        if (cell.partition == partitionId) {
-            cellNames.push_back(cell.name);
+std::vector<int> OutputGenerator::cellsByName(const Hypergraph& graph) const {
+    // Sort compact keys rather than strings: the first 8 name bytes packed
+    // big-endian order like the names themselves, so most comparisons are
+    // one integer compare and only equal prefixes look at the full names
+    struct NameKey {
+        uint64_t prefix;
+        int cellId;
+    };
+    std::vector<NameKey> keys(graph.getNumCells());
+    for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+        const std::string& name = graph.getCellName(cellId);
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; i++) {
+            prefix = (prefix << 8) | (i < name.size() ? static_cast<unsigned char>(name[i]) : 0);
         }
+        keys[cellId] = {prefix, cellId};
     }
+    std::sort(keys.begin(), keys.end(), [&graph](const NameKey& a, const NameKey& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        return graph.getCellName(a.cellId) < graph.getCellName(b.cellId);
+    });
 
-    // Sort cell names for consistent output
-    std::sort(cellNames.begin(), cellNames.end());
-
-    // Write partition header with size
-    out << label << " " << cellNames.size();
-
-    // Write cell names
-    for (const auto& name : cellNames) {
-        out << " " << name;
+    std::vector<int> order(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        order[i] = keys[i].cellId;
     }
-    out << " ;\n";
+    return order;
 }
 
-} // namespace fm 
\ No newline at end of file
+} // namespace fm
@@ -1,7 +1,8 @@
 #pragma once
 
 #include <string>
-#include "../DataStructures/Netlist.h"
+#include <vector>
+#include "../DataStructures/Hypergraph.h"
 #include "../DataStructures/PartitionState.h"
 
 namespace fm {
@@ -12,15 +13,25 @@ public:
     OutputGenerator() = default;
 
     // Generate output file
-    bool generateOutput(const std::string& filename, 
-                       const Netlist& netlist,
+    bool generateOutput(const std::string& filename,
+                       const Hypergraph& graph,
+                       const std::vector<int>& cellPartitions,
                        const PartitionState& state);
 
+    // Generate k-way output: the objective value under its own name
+    // ("Cutsize", "KM1"), then blocks G1..Gk
+    bool generateOutput(const std::string& filename,
+                       const Hypergraph& graph,
+                       const std::vector<int>& cellBlocks,
+                       int numBlocks, const std::string& objectiveName, int objectiveValue);
+
 private:
-    // Helper methods
-    void writeCutSize(std::ostream& out, int cutSize);
-    void writePartition(std::ostream& out, const Netlist& netlist, 
-                       int partitionId, const std::string& label);
+    // Helper methods. Cells are visited once in name order and appended to
+    // one buffer per block; each buffer then goes out in a single write().
+    bool writeBlocks(const std::string& filename, const Hypergraph& graph,
+                     const std::vector<int>& cellBlocks, int numBlocks,
+                     const std::string& objectiveName, int objectiveValue);
+    std::vector<int> cellsByName(const Hypergraph& graph) const;
 };
 
 } // namespace fm 
\ No newline at end of file
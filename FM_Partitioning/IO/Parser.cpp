@@ -1,12 +1,119 @@
 #include "Parser.h"
+#include "MappedFile.h"
+#include "Tokenizer.h"
+#include "../Utils/Logger.h"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
-#include <iostream>
+#include <cstdint>
+#include <string_view>
+#include <vector>
 
 namespace fm {
 
+namespace {
+
+// Full text of the line containing byte offset pos, for error messages
+std::string_view lineAt(std::string_view text, size_t pos) {
+    size_t first = text.rfind('\n', pos == 0 ? 0 : pos - 1);
+    first = (first == std::string_view::npos) ? 0 : first + 1;
+    size_t last = text.find('\n', pos);
+    if (last == std::string_view::npos) {
+        last = text.size();
+    }
+    return text.substr(first, last - first);
+}
+
+// Net weight token "[w]" right after a net name. Returns false if the
+// token is not bracketed (so it is a cell); throws if the weight is invalid.
+bool parseNetWeight(std::string_view token, int& weight) {
+    if (token.size() < 2 || token.front() != '[' || token.back() != ']') {
+        return false;
+    }
+    std::string digits(token.substr(1, token.size() - 2));
+    size_t end = 0;
+    try {
+        weight = std::stoi(digits, &end);
+    } catch (...) {
+        end = std::string::npos;
+    }
+    if (digits.empty() || end != digits.size() || weight <= 0) {
+        throw std::runtime_error("Invalid net weight: " + std::string(token));
+    }
+    return true;
+}
+
+// Open-addressing table mapping names (views into the mapped input) to dense
+// IDs. Slots hold the full hash next to the ID, so most probes never touch
+// the name bytes.
+class NameInterner {
+public:
+    // Returns the existing ID for name, or -1 after reserving the next ID
+    int findOrInsert(std::string_view name, int& id) {
+        if ((names_.size() + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        uint64_t hash = hashName(name);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots_[i];
+            if (slot.id < 0) {
+                slot.hash = hash;
+                slot.id = static_cast<int>(names_.size());
+                names_.push_back(name);
+                id = slot.id;
+                return -1;
+            }
+            if (slot.hash == hash && names_[slot.id] == name) {
+                id = slot.id;
+                return slot.id;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        int id = -1;
+    };
+    std::vector<Slot> slots_;
+    std::vector<std::string_view> names_;
+
+    static uint64_t hashName(std::string_view name) {
+        // FNV-1a; names are short and mostly differ in their last digits
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(old.empty() ? 1024 : old.size() * 2, Slot());
+        size_t mask = slots_.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.id >= 0) {
+                size_t i = slot.hash & mask;
+                while (slots_[i].id >= 0) {
+                    i = (i + 1) & mask;
+                }
+                slots_[i] = slot;
+            }
+        }
+    }
+};
+
+} // namespace
+
 bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netlist& netlist) {
+    if (mode_ == Mode::Mapped) {
+        return parseInputMapped(filename, balanceFactor, netlist);
+    }
+    return parseInputStream(filename, balanceFactor, netlist);
+}
+
+bool Parser::parseInputStream(const std::string& filename, double& balanceFactor, Netlist& netlist) {
     std::ifstream file(filename);
     if (!file) {
         throw std::runtime_error("Could not open input file: " + filename);
@@ -21,7 +128,7 @@ bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netl
         line.erase(0, line.find_first_not_of(" \t\n\r\f\v"));
         line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
         if (!parseBalanceFactor(line, balanceFactor)) {
-             std::cerr << "Error parsing balance factor line: '" << line << "'" << std::endl;
+             FM_ERROR("Error parsing balance factor line: '", line, "'");
             throw std::runtime_error("Invalid balance factor format");
         }
         balanceFactorRead = true;
@@ -33,7 +140,10 @@ bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netl
 
     // Read netlist, handling multi-line definitions
     std::string currentNetName;
+    int currentNetId = -1;
     bool parsingNetDefinition = false;
+    bool expectingNetWeight = false;  // Next token may be the optional "[w]"
+    int weight;
 
     while (std::getline(file, line)) {
         std::istringstream iss(line);
@@ -57,24 +167,30 @@ bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netl
                     // Ignore lines that are effectively empty or comments (e.g. starting with ';').
                     // The check at the start of the inner loop handles standalone ';'.
                     // If we get here with a non-"NET" token, it's unexpected.
-                    std::cerr << "Parser Error: Expected 'NET' keyword to start a definition, but found '" << token << "' on line: " << line << std::endl;
+                    FM_ERROR("Parser Error: Expected 'NET' keyword to start a definition, but found '",
+                             token, "' on line: ", line);
                     return false; // Indicate failure
                 }
 
                 // Found "NET", now expect the net name
                 if (!(iss >> currentNetName)) {
-                    std::cerr << "Parser Error: Missing net name after 'NET' on line: " << line << std::endl;
+                    FM_ERROR("Parser Error: Missing net name after 'NET' on line: ", line);
                     return false; // Indicate failure
                 }
-                netlist.addNet(currentNetName);
+                currentNetId = netlist.addNet(currentNetName);
                 parsingNetDefinition = true;
+                expectingNetWeight = true;
                 // Continue reading tokens (cells) from the *same line* in this inner loop
 
+            } else if (expectingNetWeight && parseNetWeight(token, weight)) {
+                netlist.getNetById(currentNetId)->weight = weight;
+                expectingNetWeight = false;
             } else {
+                expectingNetWeight = false;
                 // Inside a net definition, expecting cell names
                 // The semicolon case is handled above. Any other token is treated as a cell.
-                netlist.addCell(token); // addCell should handle if the cell already exists
-                netlist.addCellToNet(currentNetName, token);
+                int cellId = netlist.addCell(token); // addCell handles a cell that already exists
+                netlist.addCellToNet(currentNetId, cellId);
             }
         }
         // End of the current line reached.
@@ -87,7 +203,8 @@ bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netl
         // This means the file ended without a closing semicolon for the last net.
         // Depending on strictness, this could be an error or a warning.
         // For the assignment checker, it's likely an error.
-        std::cerr << "Parser Error: Input file ended while parsing net '" << currentNetName << "'. Missing terminating semicolon?" << std::endl;
+        FM_ERROR("Parser Error: Input file ended while parsing net '", currentNetName,
+                 "'. Missing terminating semicolon?");
         return false; // Indicate failure
     }
 
@@ -95,6 +212,96 @@ bool Parser::parseInput(const std::string& filename, double& balanceFactor, Netl
     return true;
 }
 
+bool Parser::parseInputMapped(const std::string& filename, double& balanceFactor, Netlist& netlist) {
+    MappedFile file(filename);
+    std::string_view text = file.view();
+
+    // Read balance factor first
+    size_t lineEnd = text.find('\n');
+    if (lineEnd == std::string_view::npos) {
+        lineEnd = text.size();
+    }
+    std::string line(text.substr(0, lineEnd));
+    if (line.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
+        throw std::runtime_error("No balance factor found in input file");
+    }
+    // Trim leading/trailing whitespace from balance factor line
+    line.erase(0, line.find_first_not_of(" \t\n\r\f\v"));
+    line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+    if (!parseBalanceFactor(line, balanceFactor)) {
+        FM_ERROR("Error parsing balance factor line: '", line, "'");
+        throw std::runtime_error("Invalid balance factor format");
+    }
+
+    // Names are interned once: the maps key on views into the mapping and
+    // hand out the same dense IDs the Netlist assigns, so each distinct name
+    // is appended to it without being hashed a second time.
+    NameInterner cellNames;
+    NameInterner netNames;
+    std::vector<Pin> pins;
+    pins.reserve(text.size() / 8);
+    std::string_view body = text.substr(lineEnd);
+    Tokenizer tokenizer(body);
+    std::string_view token;
+    std::string_view currentNetName;
+    int currentNetId = -1;
+    bool expectingNetWeight = false;  // Next token may be the optional "[w]"
+    int weight;
+
+    while (tokenizer.next(token)) {
+        if (token == ";") {
+            // Semicolon always terminates the current definition, if any
+            currentNetId = -1;
+            continue;
+        }
+
+        if (currentNetId < 0) {
+            // Expecting "NET" keyword to start a new definition
+            if (token != "NET") {
+                FM_ERROR("Parser Error: Expected 'NET' keyword to start a definition, but found '",
+                         token, "' on line: ", lineAt(body, tokenizer.offset()));
+                return false; // Indicate failure
+            }
+
+            // Found "NET", now expect the net name
+            if (!tokenizer.next(token) || token == ";") {
+                FM_ERROR("Parser Error: Missing net name after 'NET' on line: ",
+                         lineAt(body, tokenizer.offset()));
+                return false; // Indicate failure
+            }
+            if (netNames.findOrInsert(token, currentNetId) < 0) {
+                netlist.appendNet(std::string(token));
+            }
+            currentNetName = token;
+            expectingNetWeight = true;
+        } else if (expectingNetWeight && parseNetWeight(token, weight)) {
+            netlist.getNetById(currentNetId)->weight = weight;
+            expectingNetWeight = false;
+        } else {
+            // Inside a net definition, any other token is a cell
+            expectingNetWeight = false;
+            int cellId;
+            if (cellNames.findOrInsert(token, cellId) < 0) {
+                netlist.appendCell(std::string(token));
+            }
+            pins.push_back({currentNetId, cellId});
+        }
+    }
+
+    // Check if we were left mid-definition
+    if (currentNetId >= 0) {
+        FM_ERROR("Parser Error: Input file ended while parsing net '", currentNetName,
+                 "'. Missing terminating semicolon?");
+        return false; // Indicate failure
+    }
+
+    // Connect everything at once; duplicate pins are dropped in linear time
+    netlist.addPins(pins);
+
+    // Successfully parsed the entire file
+    return true;
+}
+
 bool Parser::parseBalanceFactor(const std::string& line, double& balanceFactor) {
     try {
         balanceFactor = std::stod(line);
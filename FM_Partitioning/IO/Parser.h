@@ -7,14 +7,22 @@ namespace fm {
 
 class Parser {
 public:
+    // Input strategies. Mapped memory-maps the file and scans it in place,
+    // interning each name once; Stream is the original getline-based reader.
+    enum class Mode { Mapped, Stream };
+
     // Constructor
-    Parser() = default;
+    explicit Parser(Mode mode = Mode::Mapped) : mode_(mode) {}
 
     // Parse input file and populate netlist
     bool parseInput(const std::string& filename, double& balanceFactor, Netlist& netlist);
 
 private:
+    Mode mode_;
+
     // Helper methods
+    bool parseInputStream(const std::string& filename, double& balanceFactor, Netlist& netlist);
+    bool parseInputMapped(const std::string& filename, double& balanceFactor, Netlist& netlist);
     bool parseBalanceFactor(const std::string& line, double& balanceFactor);
     bool parseNetLine(const std::string& line, Netlist& netlist);
 };
@@ -0,0 +1,305 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+#include "../Utils/Logger.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace fm {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t kByteOrderTag = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    double balanceFactor;
+    int32_t numCells;
+    int32_t numNets;
+    int32_t numPins;
+    int32_t maxCellDegree;
+    int32_t totalCellWeight;
+    int32_t hasNames;
+    uint64_t cellNameBytes;
+    uint64_t netNameBytes;
+};
+
+size_t padded(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+template<typename T>
+void writeArray(std::ofstream& out, const T* data, size_t count) {
+    static const char zeros[8] = {};
+    size_t bytes = count * sizeof(T);
+    if (bytes > 0) {
+        out.write(reinterpret_cast<const char*>(data), bytes);
+    }
+    out.write(zeros, padded(bytes) - bytes);
+}
+
+// Names as one byte blob plus count + 1 offsets into it
+void writeNames(std::ofstream& out, const std::vector<std::string>& names) {
+    std::vector<uint64_t> offsets(1, 0);
+    offsets.reserve(names.size() + 1);
+    for (const std::string& name : names) {
+        offsets.push_back(offsets.back() + name.size());
+    }
+    writeArray(out, offsets.data(), offsets.size());
+    std::string blob;
+    blob.reserve(offsets.back());
+    for (const std::string& name : names) {
+        blob += name;
+    }
+    writeArray(out, blob.data(), blob.size());
+}
+
+uint64_t nameBytes(const std::vector<std::string>& names) {
+    uint64_t bytes = 0;
+    for (const std::string& name : names) {
+        bytes += name.size();
+    }
+    return bytes;
+}
+
+// Sequential reader over the mapping; throws if a section runs past the end
+class SectionReader {
+public:
+    explicit SectionReader(const MappedFile& file) : data_(file.data()), size_(file.size()) {}
+
+    template<typename T>
+    const T* take(size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes > size_ - pos_ || padded(bytes) > size_ - pos_) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+        const T* section = reinterpret_cast<const T*>(data_ + pos_);
+        pos_ += padded(bytes);
+        return section;
+    }
+
+    template<typename T>
+    void takeInto(std::vector<T>& out, size_t count) {
+        const T* section = take<T>(count);
+        out.assign(section, section + count);
+    }
+
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// Offsets must start at 0, never decrease and end at total
+template<typename T>
+bool validOffsets(const std::vector<T>& offsets, T total) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != total) {
+        return false;
+    }
+    for (size_t i = 1; i < offsets.size(); i++) {
+        if (offsets[i] < offsets[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool idsInRange(const std::vector<int>& ids, int limit) {
+    for (int id : ids) {
+        if (static_cast<unsigned>(id) >= static_cast<unsigned>(limit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool allPositive(const std::vector<int>& weights) {
+    for (int weight : weights) {
+        if (weight <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The cell -> net lists must hold exactly the (cell, net) pairs of the
+// net -> pin lists. The order within a cell's list is not fixed (parsed
+// graphs keep parse order), so each list is compared sorted against the
+// transpose built in net order.
+bool isTranspose(const Hypergraph& graph, const std::vector<int>& cellNetOffsets,
+                 const std::vector<int>& cellNets) {
+    const int numCells = graph.getNumCells();
+    std::vector<int> cursor(cellNetOffsets.begin(), cellNetOffsets.end() - 1);
+    std::vector<int> expected(cellNets.size());
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
+        for (int cellId : graph.getNetPins(netId)) {
+            if (cursor[cellId] == cellNetOffsets[cellId + 1]) {
+                return false;  // More pins on this cell than its list holds
+            }
+            expected[cursor[cellId]++] = netId;
+        }
+    }
+    std::vector<int> nets;
+    for (int cellId = 0; cellId < numCells; cellId++) {
+        if (cursor[cellId] != cellNetOffsets[cellId + 1]) {
+            return false;
+        }
+        nets.assign(cellNets.begin() + cellNetOffsets[cellId], cellNets.begin() + cellNetOffsets[cellId + 1]);
+        std::sort(nets.begin(), nets.end());
+        if (!std::equal(nets.begin(), nets.end(), expected.begin() + cellNetOffsets[cellId])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void readNames(SectionReader& reader, int count, uint64_t bytes, std::vector<std::string>& names) {
+    const uint64_t* offsets = reader.take<uint64_t>(count + 1);
+    const char* blob = reader.take<char>(bytes);
+    if (offsets[0] != 0 || offsets[count] != bytes) {
+        throw std::runtime_error("Snapshot name table is corrupt");
+    }
+    names.clear();
+    names.reserve(count);
+    for (int i = 0; i < count; i++) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw std::runtime_error("Snapshot name table is corrupt");
+        }
+        names.emplace_back(blob + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+}
+
+} // namespace
+
+bool Snapshot::isSnapshot(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool Snapshot::write(const std::string& filename, const Hypergraph& graph, double balanceFactor) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        FM_ERROR("Error: Could not open snapshot file for writing: ", filename);
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderTag;
+    header.balanceFactor = balanceFactor;
+    header.numCells = graph.getNumCells();
+    header.numNets = graph.getNumNets();
+    header.numPins = graph.getNumPins();
+    header.maxCellDegree = graph.getMaxCellDegree();
+    header.totalCellWeight = graph.getTotalCellWeight();
+    header.hasNames = graph.hasNames() ? 1 : 0;
+    header.cellNameBytes = nameBytes(graph.cellNames_);
+    header.netNameBytes = nameBytes(graph.netNames_);
+    writeArray(out, &header, 1);
+
+    writeArray(out, graph.netPinOffsets_.data(), graph.netPinOffsets_.size());
+    writeArray(out, graph.netPins_.data(), graph.netPins_.size());
+    writeArray(out, graph.cellNetOffsets_.data(), graph.cellNetOffsets_.size());
+    writeArray(out, graph.cellNets_.data(), graph.cellNets_.size());
+    writeArray(out, graph.cellWeights_.data(), graph.cellWeights_.size());
+    writeArray(out, graph.netWeights_.data(), graph.netWeights_.size());
+    if (header.hasNames) {
+        writeNames(out, graph.cellNames_);
+        writeNames(out, graph.netNames_);
+    }
+
+    if (!out.flush()) {
+        FM_ERROR("Error: Failed writing snapshot file: ", filename);
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::load(const std::string& filename, double& balanceFactor, Hypergraph& graph) {
+    try {
+        MappedFile file(filename);
+        SectionReader reader(file);
+
+        const SnapshotHeader& header = *reader.take<SnapshotHeader>(1);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("Not a snapshot file");
+        }
+        if (header.byteOrder != kByteOrderTag) {
+            throw std::runtime_error("Snapshot was written with a different byte order");
+        }
+        if (header.version != kVersion) {
+            throw std::runtime_error("Snapshot version " + std::to_string(header.version) +
+                                     " is not supported (expected " + std::to_string(kVersion) + ")");
+        }
+        if (header.numCells < 0 || header.numNets < 0 || header.numPins < 0) {
+            throw std::runtime_error("Snapshot header is corrupt");
+        }
+        // Same range the parser accepts; written this way NaN fails it too
+        if (!(header.balanceFactor >= 0.0 && header.balanceFactor <= 1.0)) {
+            throw std::runtime_error("Snapshot has an invalid balance factor");
+        }
+
+        Hypergraph loaded;
+        reader.takeInto(loaded.netPinOffsets_, header.numNets + 1);
+        reader.takeInto(loaded.netPins_, header.numPins);
+        reader.takeInto(loaded.cellNetOffsets_, header.numCells + 1);
+        reader.takeInto(loaded.cellNets_, header.numPins);
+        reader.takeInto(loaded.cellWeights_, header.numCells);
+        reader.takeInto(loaded.netWeights_, header.numNets);
+        if (header.hasNames) {
+            readNames(reader, header.numCells, header.cellNameBytes, loaded.cellNames_);
+            readNames(reader, header.numNets, header.netNameBytes, loaded.netNames_);
+        }
+        if (!reader.atEnd()) {
+            throw std::runtime_error("Snapshot has trailing data");
+        }
+
+        // The engine indexes with these unchecked, and sizes its gain
+        // buckets from the degree and weights, so a corrupt file must not
+        // get past here
+        if (!validOffsets(loaded.netPinOffsets_, header.numPins) ||
+            !validOffsets(loaded.cellNetOffsets_, header.numPins) ||
+            !idsInRange(loaded.netPins_, header.numCells) ||
+            !idsInRange(loaded.cellNets_, header.numNets) ||
+            !isTranspose(loaded, loaded.cellNetOffsets_, loaded.cellNets_)) {
+            throw std::runtime_error("Snapshot adjacency is corrupt");
+        }
+        if (!allPositive(loaded.cellWeights_) || !allPositive(loaded.netWeights_)) {
+            throw std::runtime_error("Snapshot has a non-positive weight");
+        }
+
+        // Derived fields are recomputed; the header copies only have to agree
+        long long totalCellWeight = 0;
+        for (int weight : loaded.cellWeights_) {
+            totalCellWeight += weight;
+        }
+        for (int cellId = 0; cellId < header.numCells; cellId++) {
+            loaded.maxCellDegree_ = std::max(loaded.maxCellDegree_, loaded.getCellDegree(cellId));
+        }
+        if (totalCellWeight > INT_MAX || totalCellWeight != header.totalCellWeight ||
+            loaded.maxCellDegree_ != header.maxCellDegree) {
+            throw std::runtime_error("Snapshot header does not match its arrays");
+        }
+        loaded.totalCellWeight_ = static_cast<int>(totalCellWeight);
+
+        balanceFactor = header.balanceFactor;
+        graph = std::move(loaded);
+        return true;
+    } catch (const std::exception& e) {
+        FM_ERROR("Error loading snapshot ", filename, ": ", e.what());
+        return false;
+    }
+}
+
+} // namespace fm
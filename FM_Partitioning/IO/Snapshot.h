@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "../DataStructures/Hypergraph.h"
+
+namespace fm {
+
+// Binary snapshot of a parsed hypergraph and its balance factor, so the
+// same netlist can be partitioned many times without re-parsing the text.
+//
+// Layout (native byte order, every section 8-byte aligned):
+//   header        magic "FMSNAP\0\0", version, byte-order tag, balance
+//                 factor, counts and name blob sizes
+//   CSR arrays    netPinOffsets, netPins, cellNetOffsets, cellNets (int32)
+//   weights       cellWeights, netWeights (int32)
+//   names         cell name offsets (uint64) + bytes, same for nets
+//                 (both empty for unnamed graphs)
+//
+// The loader maps the file once and copies every array straight into the
+// hypergraph. It then checks that the balance factor lies in [0, 1], the
+// two adjacency sides are transposes of each other and every weight is
+// positive, and recomputes the maximum cell degree and total cell weight; a
+// header that disagrees with them is rejected, as is a snapshot from another
+// version or byte order.
+class Snapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    // True if the file starts with the snapshot magic
+    static bool isSnapshot(const std::string& filename);
+
+    // Both report errors through the log and return false on failure
+    static bool write(const std::string& filename, const Hypergraph& graph, double balanceFactor);
+    static bool load(const std::string& filename, double& balanceFactor, Hypergraph& graph);
+};
+
+} // namespace fm
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fm {
+
+// Zero-copy tokenizer for the .dat netlist format. Tokens are separated by
+// whitespace (any byte <= ' '), and ';' is always returned as a token of its
+// own, even when written directly after a name. Returned views point into the
+// scanned buffer. The inner scans process 16 bytes at a time with SSE2.
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view text)
+        : begin_(text.data()), cur_(text.data()), end_(text.data() + text.size()) {}
+
+    // Returns false at end of input
+    bool next(std::string_view& token) {
+        cur_ = skipSpaces(cur_, end_);
+        if (cur_ == end_) {
+            return false;
+        }
+        const char* start = cur_;
+        if (*cur_ == ';') {
+            cur_++;
+        } else {
+            cur_ = findDelimiter(cur_, end_);
+        }
+        token = std::string_view(start, static_cast<size_t>(cur_ - start));
+        return true;
+    }
+
+    // Byte offset of the scan position, for error reporting
+    size_t offset() const { return static_cast<size_t>(cur_ - begin_); }
+
+private:
+    const char* begin_;
+    const char* cur_;
+    const char* end_;
+
+    static bool isSpace(char c) { return static_cast<unsigned char>(c) <= ' '; }
+    static bool isDelimiter(char c) { return isSpace(c) || c == ';'; }
+
+#if defined(__SSE2__)
+    // Bit i set when byte i of the block is <= ' '
+    static unsigned spaceMask(__m128i block) {
+        const __m128i space = _mm_set1_epi8(' ');
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(block, space), space)));
+    }
+#endif
+
+    static const char* skipSpaces(const char* p, const char* end) {
+#if defined(__SSE2__)
+        while (end - p >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned nonSpace = ~spaceMask(block) & 0xFFFFu;
+            if (nonSpace) {
+                return p + __builtin_ctz(nonSpace);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && isSpace(*p)) {
+            p++;
+        }
+        return p;
+    }
+
+    static const char* findDelimiter(const char* p, const char* end) {
+#if defined(__SSE2__)
+        const __m128i semicolon = _mm_set1_epi8(';');
+        while (end - p >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned delimiters = spaceMask(block) |
+                static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, semicolon)));
+            if (delimiters) {
+                return p + __builtin_ctz(delimiters);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && !isDelimiter(*p)) {
+            p++;
+        }
+        return p;
+    }
+};
+
+} // namespace fm
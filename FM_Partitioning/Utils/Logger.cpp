@@ -0,0 +1,35 @@
+#include "Logger.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+namespace fm {
+namespace log {
+
+namespace {
+
+std::atomic<Level> runtimeLevel{Level::INFO};
+std::mutex outputMutex;
+
+} // namespace
+
+void setLevel(Level level) {
+    runtimeLevel.store(level, std::memory_order_relaxed);
+}
+
+Level getLevel() {
+    return runtimeLevel.load(std::memory_order_relaxed);
+}
+
+void write(Level level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (level >= Level::WARNING) {
+        std::cerr << message << '\n';  // Unbuffered
+    } else {
+        // No flush: the hot paths used to pay for std::endl on every line
+        std::cout << message << '\n';
+    }
+}
+
+} // namespace log
+} // namespace fm
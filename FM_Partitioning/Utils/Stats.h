@@ -0,0 +1,16 @@
+#pragma once
+
+// Instrumentation counters for the engine and the gain bucket.
+//
+// FM_STAT wraps a counter update so it disappears entirely when the build
+// is configured with -DFM_STATS=OFF; the counters then stay 0.
+//
+//   FM_STAT(neighborVisits_++);
+
+#ifdef FM_STATS
+#define FM_STATS_ENABLED 1
+#define FM_STAT(...) do { __VA_ARGS__; } while (0)
+#else
+#define FM_STATS_ENABLED 0
+#define FM_STAT(...) do { } while (0)
+#endif
@@ -0,0 +1,161 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace fm {
+
+ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    unsigned index = nextQueue_++ % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        queued_++;
+        pending_++;
+    }
+    workAvailable_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    allDone_.wait(lock, [this] { return pending_ == 0; });
+    if (firstError_) {
+        std::exception_ptr error = firstError_;
+        firstError_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(int index) {
+    while (true) {
+        {
+            // Reserve one queued task; it is then guaranteed to be in some deque
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            workAvailable_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (queued_ == 0) {
+                return;  // Stopping and nothing left to run
+            }
+            queued_--;
+        }
+
+        std::function<void()> task = takeTask(index);
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (error && !firstError_) {
+            firstError_ = error;
+        }
+        if (--pending_ == 0) {
+            allDone_.notify_all();
+        }
+    }
+}
+
+std::function<void()> ThreadPool::takeTask(int index) {
+    const int numQueues = static_cast<int>(queues_.size());
+    while (true) {
+        // Own deque first (LIFO), then steal from the others (FIFO)
+        for (int offset = 0; offset < numQueues; offset++) {
+            WorkerQueue& queue = *queues_[(index + offset) % numQueues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                std::function<void()> task;
+                if (offset == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return task;
+            }
+        }
+        // Another worker took the task this scan was heading for; rescan
+        std::this_thread::yield();
+    }
+}
+
+namespace {
+
+// Chunk boundaries for the parallel loops: numChunks equal-ish ranges
+int numChunks(const ThreadPool* pool, int count, int minChunk) {
+    if (!pool || count <= 0) {
+        return 1;
+    }
+    int byThreads = pool->getNumThreads() * 4;
+    int bySize = count / std::max(1, minChunk);
+    return std::max(1, std::min(byThreads, bySize));
+}
+
+int chunkBegin(int chunk, int chunks, int count) {
+    return static_cast<int>(static_cast<long long>(count) * chunk / chunks);
+}
+
+} // namespace
+
+void parallelFor(ThreadPool* pool, int count, int minChunk,
+                 const std::function<void(int begin, int end)>& body) {
+    int chunks = numChunks(pool, count, minChunk);
+    if (chunks == 1) {
+        body(0, count);
+        return;
+    }
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int begin = chunkBegin(chunk, chunks, count);
+        int end = chunkBegin(chunk + 1, chunks, count);
+        pool->submit([&body, begin, end] { body(begin, end); });
+    }
+    pool->wait();
+}
+
+long long parallelSum(ThreadPool* pool, int count, int minChunk,
+                      const std::function<long long(int begin, int end)>& body) {
+    int chunks = numChunks(pool, count, minChunk);
+    if (chunks == 1) {
+        return body(0, count);
+    }
+    std::vector<long long> partial(chunks, 0);
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int begin = chunkBegin(chunk, chunks, count);
+        int end = chunkBegin(chunk + 1, chunks, count);
+        pool->submit([&body, &partial, chunk, begin, end] { partial[chunk] = body(begin, end); });
+    }
+    pool->wait();
+
+    long long sum = 0;
+    for (long long value : partial) {
+        sum += value;
+    }
+    return sum;
+}
+
+} // namespace fm
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fm {
+
+// Fixed-size pool of worker threads with one task deque per worker.
+// Submitted tasks are spread round-robin over the deques; a worker pops from
+// the back of its own deque and, when that is empty, steals from the front
+// of the others, so uneven task lengths do not leave threads idle.
+class ThreadPool {
+public:
+    // Constructor/Destructor
+    explicit ThreadPool(int numThreads = 0);  // 0 = hardware concurrency
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Task management
+    void submit(std::function<void()> task);
+    void wait();  // Blocks until every submitted task finished; rethrows the first task exception
+
+    // Accessors
+    int getNumThreads() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<unsigned> nextQueue_{0};
+
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    int queued_ = 0;         // Tasks sitting in some deque
+    int pending_ = 0;        // Tasks submitted but not finished
+    bool stopping_ = false;
+    std::exception_ptr firstError_;
+
+    // Helper methods
+    void workerLoop(int index);
+    std::function<void()> takeTask(int index);
+};
+
+// Data-parallel loops over [0, count). The range is cut into contiguous
+// chunks of at least minChunk items (about four per thread) that run on the
+// pool and are waited for; without a pool, or for small counts, the body
+// runs inline. Chunk boundaries depend only on the arguments, and
+// parallelSum adds the per-chunk sums in chunk order, so results do not
+// depend on scheduling.
+void parallelFor(ThreadPool* pool, int count, int minChunk,
+                 const std::function<void(int begin, int end)>& body);
+long long parallelSum(ThreadPool* pool, int count, int minChunk,
+                      const std::function<long long(int begin, int end)>& body);
+
+} // namespace fm
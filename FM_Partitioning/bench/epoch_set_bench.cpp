@@ -0,0 +1,80 @@
+// Micro-benchmark for the per-move "already moved this pass?" bookkeeping in
+// FMEngine::runPass: a fresh std::unordered_set<int> per pass (the previous
+// implementation) against the engine's reusable EpochSet.
+//
+// Usage: epoch_set_bench [num_cells] [passes]
+// Every pass looks up and inserts each cell once, in a random order, which
+// is the access pattern of a full F-M pass.
+
+#include "DataStructures/EpochSet.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nsPerMove(Clock::time_point start, Clock::time_point end, long long moves) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / moves;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int numCells = argc > 1 ? std::atoi(argv[1]) : 382489;  // input_5.dat
+    int passes = argc > 2 ? std::atoi(argv[2]) : 10;
+    if (numCells <= 0 || passes <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [num_cells] [passes]" << std::endl;
+        return 1;
+    }
+
+    // One random move order per pass, shared by both variants
+    std::mt19937 rng(1);
+    std::vector<std::vector<int>> orders(passes, std::vector<int>(numCells));
+    for (auto& order : orders) {
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+    const long long moves = static_cast<long long>(numCells) * passes;
+    long long hits = 0;  // Keeps the lookups from being optimized away
+
+    auto start = Clock::now();
+    for (const auto& order : orders) {
+        std::unordered_set<int> movedCells;
+        for (int cellId : order) {
+            if (movedCells.find(cellId) != movedCells.end()) {
+                hits++;
+            }
+            movedCells.insert(cellId);
+        }
+    }
+    auto end = Clock::now();
+    double setCost = nsPerMove(start, end, moves);
+
+    fm::EpochSet movedCells;
+    start = Clock::now();
+    movedCells.resize(numCells);
+    for (const auto& order : orders) {
+        movedCells.clear();
+        for (int cellId : order) {
+            if (movedCells.contains(cellId)) {
+                hits++;
+            }
+            movedCells.insert(cellId);
+        }
+    }
+    end = Clock::now();
+    double epochCost = nsPerMove(start, end, moves);
+
+    std::cout << "cells: " << numCells << ", passes: " << passes << ", hits: " << hits << "\n"
+              << "std::unordered_set: " << setCost << " ns/move\n"
+              << "EpochSet:           " << epochCost << " ns/move\n"
+              << "speedup:            " << setCost / epochCost << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,442 @@
+// Reproducible end-to-end benchmark for the partitioner.
+//
+// Usage: fm_bench [options] [input.dat ...]
+//   --runs K           Runs per input and mode (default: 3); run r uses seed S + r
+//   --seed S           Base seed (default: 1)
+//   --modes LIST       Comma-separated subset of flat,multilevel,multistart (default: all)
+//   --starts N         Starts per multistart run (default: 4)
+//   --threads T        Multistart worker threads (default: all hardware threads)
+//   --reorder M        Renumber cells first: none, bfs or rcm (default: none);
+//                      the time is counted as build time
+//   --parser M         Text reader: mapped or stream (default: mapped)
+//   --format json|csv  Output format (default: json)
+//   --output FILE      Write results to FILE instead of stdout
+//
+// Without inputs, every input_pa1/input_*.dat under the working directory is
+// used, in numeric order. Inputs may also be binary snapshots (see
+// IO/Snapshot.h); their load time is reported as parse time. Every run
+// parses the input again. Times are wall clock milliseconds. Peak RSS is
+// the process high-water mark, reset before each run (heap trimmed, then
+// /proc/self/clear_refs) where the platform allows it, so a run does not
+// inherit the peak of an earlier, larger one.
+
+#include "DataStructures/Hypergraph.h"
+#include "DataStructures/Netlist.h"
+#include "IO/Parser.h"
+#include "IO/Snapshot.h"
+#include "Algorithm/FMEngine.h"
+#include "Algorithm/Multilevel.h"
+#include "Algorithm/MultiStart.h"
+#include "Algorithm/Reorder.h"
+#include "Utils/Logger.h"
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace fm;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    int runs = 3;
+    unsigned seed = 1;
+    std::vector<std::string> modes = {"flat", "multilevel", "multistart"};
+    int starts = 4;
+    int threads = 0;
+    CellOrdering ordering = CellOrdering::NONE;
+    Parser::Mode parserMode = Parser::Mode::Mapped;
+    std::string format = "json";
+    std::string output;
+    std::vector<std::string> inputs;
+};
+
+struct RunResult {
+    std::string input;
+    std::string mode;
+    int run = 0;
+    unsigned seed = 0;
+    int cells = 0;
+    int nets = 0;
+    int pins = 0;
+    double parseMs = 0.0;         // Text -> Netlist
+    double buildMs = 0.0;         // Netlist -> Hypergraph
+    double initMs = -1.0;         // FMEngine construction (flat only)
+    double runMs = 0.0;           // Partitioning
+    double totalMs = 0.0;
+    int passes = -1;              // Flat only
+    long long moves = -1;         // Flat only
+    double movesPerSec = -1.0;    // Flat only
+    std::vector<double> passMs;   // Flat only
+    long peakRssKb = 0;
+    int cut = 0;
+    bool balanced = false;
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void resetPeakRss() {
+#ifdef __GLIBC__
+    // Hand memory freed by the previous run back to the OS first, so the
+    // reset baseline is what this process really holds
+    malloc_trim(0);
+#endif
+    // "5" resets the VmHWM high-water mark to the current RSS (Linux 4.0+)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs) {
+        clearRefs << "5";
+    }
+}
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    // Not Linux: fall back to the (non-resettable) process peak
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// input_N.dat files in numeric order
+std::vector<std::string> defaultInputs() {
+    std::vector<std::pair<int, std::string>> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("input_pa1", error)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("input_", 0) == 0 && entry.path().extension() == ".dat") {
+            try {
+                found.emplace_back(std::stoi(name.substr(6)), entry.path().string());
+            } catch (const std::exception&) {
+                // Not input_<number>.dat
+            }
+        }
+    }
+    std::sort(found.begin(), found.end());
+    std::vector<std::string> inputs;
+    for (const auto& input : found) {
+        inputs.push_back(input.second);
+    }
+    return inputs;
+}
+
+RunResult runOnce(const std::string& input, const std::string& mode, int run,
+                  const BenchOptions& options) {
+    RunResult result;
+    result.input = input;
+    result.mode = mode;
+    result.run = run;
+    result.seed = options.seed + run;
+
+    resetPeakRss();
+    auto totalStart = Clock::now();
+
+    double balanceFactor;
+    Hypergraph graph;
+    if (Snapshot::isSnapshot(input)) {
+        // Loading is the whole front end; build time stays 0
+        auto start = Clock::now();
+        if (!Snapshot::load(input, balanceFactor, graph)) {
+            throw std::runtime_error("Could not load " + input);
+        }
+        result.parseMs = msSince(start);
+        if (options.ordering != CellOrdering::NONE) {
+            start = Clock::now();
+            graph = reorderHypergraph(graph, options.ordering);
+            result.buildMs = msSince(start);
+        }
+    } else {
+        Netlist netlist;
+        auto start = Clock::now();
+        Parser parser(options.parserMode);
+        if (!parser.parseInput(input, balanceFactor, netlist)) {
+            throw std::runtime_error("Could not parse " + input);
+        }
+        result.parseMs = msSince(start);
+
+        start = Clock::now();
+        graph = Hypergraph(netlist);
+        if (options.ordering != CellOrdering::NONE) {
+            graph = reorderHypergraph(graph, options.ordering);
+        }
+        result.buildMs = msSince(start);
+    }
+    result.cells = graph.getNumCells();
+    result.nets = graph.getNumNets();
+    result.pins = graph.getNumPins();
+
+    FMOptions fmOptions;
+    fmOptions.seed = result.seed;
+    const FMEngine* engine = nullptr;
+    std::unique_ptr<FMEngine> flatEngine;
+    std::unique_ptr<MultilevelPartitioner> multilevel;
+    std::unique_ptr<MultiStartPartitioner> multiStart;
+
+    if (mode == "flat") {
+        auto start = Clock::now();
+        flatEngine = std::make_unique<FMEngine>(graph, balanceFactor, fmOptions);
+        result.initMs = msSince(start);
+
+        start = Clock::now();
+        flatEngine->run();
+        result.runMs = msSince(start);
+        engine = flatEngine.get();
+
+        result.passes = static_cast<int>(engine->getPassSummaries().size());
+        result.moves = 0;
+        for (const PassSummary& pass : engine->getPassSummaries()) {
+            result.moves += pass.moves;
+            result.passMs.push_back(pass.seconds * 1000.0);
+        }
+        result.movesPerSec = result.runMs > 0.0 ? result.moves / (result.runMs / 1000.0) : 0.0;
+    } else if (mode == "multilevel") {
+        MultilevelOptions multilevelOptions;
+        multilevelOptions.seed = result.seed;
+        multilevelOptions.fmOptions = fmOptions;
+        auto start = Clock::now();
+        multilevel = std::make_unique<MultilevelPartitioner>(graph, balanceFactor, multilevelOptions);
+        multilevel->run();
+        result.runMs = msSince(start);
+        engine = &multilevel->getEngine();
+    } else {
+        MultiStartOptions multiStartOptions;
+        multiStartOptions.starts = options.starts;
+        multiStartOptions.threads = options.threads;
+        multiStartOptions.seed = result.seed;
+        multiStartOptions.fmOptions = fmOptions;
+        auto start = Clock::now();
+        multiStart = std::make_unique<MultiStartPartitioner>(graph, balanceFactor, multiStartOptions);
+        multiStart->run();
+        result.runMs = msSince(start);
+        engine = &multiStart->getEngine();
+    }
+
+    const PartitionState& state = engine->getPartitionState();
+    result.cut = state.getCurrentCutSize();
+    result.balanced = state.isBalanced(state.getPartitionSize(0), state.getPartitionSize(1));
+    result.totalMs = msSince(totalStart);
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+// Flat-only fields are null (JSON) or empty (CSV) for the other modes
+template<typename T>
+std::string optional(T value, bool present, const char* absent) {
+    if (!present) {
+        return absent;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << value;
+    return oss.str();
+}
+
+void writeJson(std::ostream& out, const std::vector<RunResult>& results) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const RunResult& r = results[i];
+        bool flat = r.initMs >= 0.0;
+        out << (i ? "," : "") << "\n    {"
+            << "\"input\": " << jsonString(r.input)
+            << ", \"mode\": " << jsonString(r.mode)
+            << ", \"run\": " << r.run
+            << ", \"seed\": " << r.seed
+            << ", \"cells\": " << r.cells
+            << ", \"nets\": " << r.nets
+            << ", \"pins\": " << r.pins
+            << ", \"parse_ms\": " << r.parseMs
+            << ", \"build_ms\": " << r.buildMs
+            << ", \"init_ms\": " << optional(r.initMs, flat, "null")
+            << ", \"run_ms\": " << r.runMs
+            << ", \"total_ms\": " << r.totalMs
+            << ", \"passes\": " << optional(r.passes, flat, "null")
+            << ", \"moves\": " << optional(r.moves, flat, "null")
+            << ", \"moves_per_sec\": " << optional(r.movesPerSec, flat, "null")
+            << ", \"pass_ms\": ";
+        if (flat) {
+            out << "[";
+            for (size_t p = 0; p < r.passMs.size(); p++) {
+                out << (p ? ", " : "") << r.passMs[p];
+            }
+            out << "]";
+        } else {
+            out << "null";
+        }
+        out << ", \"peak_rss_kb\": " << r.peakRssKb
+            << ", \"cut\": " << r.cut
+            << ", \"balanced\": " << (r.balanced ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<RunResult>& results) {
+    out << std::fixed << std::setprecision(3);
+    out << "input,mode,run,seed,cells,nets,pins,parse_ms,build_ms,init_ms,run_ms,total_ms,"
+           "passes,moves,moves_per_sec,pass_ms,peak_rss_kb,cut,balanced\n";
+    for (const RunResult& r : results) {
+        bool flat = r.initMs >= 0.0;
+        std::ostringstream passMs;  // ';'-separated so the row stays one CSV field
+        passMs << std::fixed << std::setprecision(3);
+        for (size_t p = 0; p < r.passMs.size(); p++) {
+            passMs << (p ? ";" : "") << r.passMs[p];
+        }
+        out << r.input << "," << r.mode << "," << r.run << "," << r.seed << ","
+            << r.cells << "," << r.nets << "," << r.pins << ","
+            << r.parseMs << "," << r.buildMs << "," << optional(r.initMs, flat, "") << ","
+            << r.runMs << "," << r.totalMs << ","
+            << optional(r.passes, flat, "") << "," << optional(r.moves, flat, "") << ","
+            << optional(r.movesPerSec, flat, "") << "," << passMs.str() << ","
+            << r.peakRssKb << "," << r.cut << "," << (r.balanced ? 1 : 0) << "\n";
+    }
+}
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [--runs K] [--seed S]"
+              << " [--modes flat,multilevel,multistart] [--starts N] [--threads T]"
+              << " [--reorder none|bfs|rcm] [--parser mapped|stream]"
+              << " [--format json|csv] [--output FILE] [input.dat ...]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--runs" && hasValue) {
+                options.runs = std::stoi(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--modes" && hasValue) {
+                options.modes.clear();
+                std::istringstream list(argv[++i]);
+                std::string mode;
+                while (std::getline(list, mode, ',')) {
+                    if (mode != "flat" && mode != "multilevel" && mode != "multistart") {
+                        throw std::invalid_argument(mode);
+                    }
+                    options.modes.push_back(mode);
+                }
+            } else if (arg == "--starts" && hasValue) {
+                options.starts = std::stoi(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = std::stoi(argv[++i]);
+            } else if (arg == "--reorder" && hasValue) {
+                std::string mode = argv[++i];
+                if (mode == "none") {
+                    options.ordering = CellOrdering::NONE;
+                } else if (mode == "bfs") {
+                    options.ordering = CellOrdering::BFS;
+                } else if (mode == "rcm") {
+                    options.ordering = CellOrdering::RCM;
+                } else {
+                    throw std::invalid_argument(mode);
+                }
+            } else if (arg == "--parser" && hasValue) {
+                std::string mode = argv[++i];
+                if (mode == "mapped") {
+                    options.parserMode = Parser::Mode::Mapped;
+                } else if (mode == "stream") {
+                    options.parserMode = Parser::Mode::Stream;
+                } else {
+                    throw std::invalid_argument(mode);
+                }
+            } else if (arg == "--format" && hasValue) {
+                options.format = argv[++i];
+                if (options.format != "json" && options.format != "csv") {
+                    throw std::invalid_argument(options.format);
+                }
+            } else if (arg == "--output" && hasValue) {
+                options.output = argv[++i];
+            } else if (arg.rfind("--", 0) == 0) {
+                printUsage(argv[0]);
+                return 1;
+            } else {
+                options.inputs.push_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (options.runs < 1 || options.starts < 1 || options.modes.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.inputs.empty()) {
+        options.inputs = defaultInputs();
+        if (options.inputs.empty()) {
+            std::cerr << "No input_pa1/input_*.dat found; pass input files explicitly" << std::endl;
+            return 1;
+        }
+    }
+
+    // The partitioner's own progress output would swamp the results
+    fm::log::setLevel(fm::log::Level::ERROR);
+
+    std::vector<RunResult> results;
+    try {
+        for (const std::string& input : options.inputs) {
+            for (const std::string& mode : options.modes) {
+                for (int run = 0; run < options.runs; run++) {
+                    results.push_back(runOnce(input, mode, run, options));
+                    const RunResult& r = results.back();
+                    std::cerr << input << " " << mode << " run " << run << ": cut " << r.cut
+                              << ", " << r.totalMs << " ms" << std::endl;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Could not open " << options.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    if (options.format == "csv") {
+        writeCsv(out, results);
+    } else {
+        writeJson(out, results);
+    }
+    return 0;
+}
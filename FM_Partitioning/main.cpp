@@ -1,97 +1,90 @@
 #include <iostream>
 #include <string>
 #include <chrono>
-#include <set>
-#include <unordered_map>
+#include <fstream>
+#include <algorithm>
 #include <climits>
+#include <memory>
+#include <stdexcept>
 
 #include "DataStructures/Netlist.h"
+#include "DataStructures/Hypergraph.h"
 #include "IO/Parser.h"
 #include "IO/OutputGenerator.h"
+#include "IO/Snapshot.h"
 #include "Algorithm/FMEngine.h"
+#include "Algorithm/Multilevel.h"
+#include "Algorithm/MultiStart.h"
+#include "Algorithm/KWay.h"
+#include "Algorithm/Reorder.h"
+#include "Utils/Logger.h"
 
 using namespace fm;
 
 void printUsage(const char* programName) {
-    std::cerr << "Usage: " << programName << " <input_file> <output_file>" << std::endl;
+    std::cerr << "Usage: " << programName << " <input_file> <output_file> [--test] [--multilevel]"
+              << " [--starts N] [--threads T] [--seed S] [--tie-break lifo|fifo|random]"
+              << " [--large-net N] [--init sequential|random|bfs|cluster] [--reorder none|bfs|rcm]"
+              << " [--kway K] [--objective cut|km1] [--time-budget SEC] [--min-rate R]"
+              << " [--max-passes N] [--stats FILE] [--write-snapshot FILE] [--quiet]" << std::endl;
 }
 
 // Function to validate Phase 1 implementation
-bool validatePhase1(const Netlist& netlist, const PartitionState& partitionState, double balanceFactor) {
-    std::cout << "\n============== PHASE 1 VALIDATION ==============\n" << std::endl;
+bool validatePhase1(const Hypergraph& graph, const FMEngine& engine, double balanceFactor) {
+    FM_INFO("\n============== PHASE 1 VALIDATION ==============\n");
     bool isValid = true;
+    const PartitionState& partitionState = engine.getPartitionState();
+    const std::vector<int>& cellPartitions = engine.getCellPartitions();
     
     // 1. Validate input parsing results
-    std::cout << "1. Input Parsing Validation" << std::endl;
-    std::cout << "   - Total cells: " << netlist.getCells().size() << std::endl;
+    FM_INFO("1. Input Parsing Validation");
+    FM_INFO("   - Total cells: ", graph.getNumCells());
+    FM_INFO("   - Total nets: ", graph.getNumNets());
+    FM_INFO("   - Balance factor: ", balanceFactor);
     
-    // Since getNets() doesn't have a const version, we'll work around this
-    const auto& nets = const_cast<Netlist&>(netlist).getNets();
-    std::cout << "   - Total nets: " << nets.size() << std::endl;
-    std::cout << "   - Balance factor: " << balanceFactor << std::endl;
-    
-    if (netlist.getCells().empty()) {
-        std::cout << "   [ERROR] No cells parsed from input" << std::endl;
+    if (graph.getNumCells() == 0) {
+        FM_ERROR("   [ERROR] No cells parsed from input");
         isValid = false;
     }
     
-    if (nets.empty()) {
-        std::cout << "   [ERROR] No nets parsed from input" << std::endl;
+    if (graph.getNumNets() == 0) {
+        FM_ERROR("   [ERROR] No nets parsed from input");
         isValid = false;
     }
     
     // 2. Verify netlist connectivity
-    std::cout << "\n2. Netlist Connectivity Validation" << std::endl;
+    FM_INFO("\n2. Netlist Connectivity Validation");
     
-    // Check cell-net relationship consistency
+    // Check cell-net relationship consistency: every pin of a net must list
+    // that net among its cell's nets, and both directions must agree in size
     bool hasConnectivityIssues = false;
-    std::unordered_map<std::string, std::set<std::string>> cellToNets;
-    std::unordered_map<std::string, std::set<std::string>> netToCells;
-    
-    // First collect all relationships
-    for (const auto& cell : netlist.getCells()) {
-        for (int netId : cell.netIds) {
-            const Net* net = netlist.getNetById(netId);
-            if (net) {
-                cellToNets[cell.name].insert(net->name);
-            }
-        }
-    }
+    long long netToCellPins = 0;
+    long long cellToNetPins = 0;
     
-    for (const auto& net : nets) {
-        for (int cellId : net.cellIds) {
-            const Cell* cell = netlist.getCellById(cellId);
-            if (cell) {
-                netToCells[net.name].insert(cell->name);
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
+        for (int cellId : graph.getNetPins(netId)) {
+            netToCellPins++;
+            IdSpan cellNets = graph.getCellNets(cellId);
+            if (std::find(cellNets.begin(), cellNets.end(), netId) == cellNets.end()) {
+                FM_ERROR("   [ERROR] Net-Cell relationship mismatch: Net ", graph.getNetName(netId),
+                         " connects to Cell ", graph.getCellName(cellId), " but not vice versa");
+                hasConnectivityIssues = true;
             }
         }
     }
     
-    // Check bidirectional consistency
-    for (const auto& [cellName, connectedNets] : cellToNets) {
-        for (const auto& netName : connectedNets) {
-            if (netToCells[netName].find(cellName) == netToCells[netName].end()) {
-                std::cout << "   [ERROR] Cell-Net relationship mismatch: Cell " << cellName 
-                          << " connects to Net " << netName 
-                          << " but not vice versa" << std::endl;
-                hasConnectivityIssues = true;
-            }
-        }
+    for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+        cellToNetPins += graph.getCellDegree(cellId);
     }
     
-    for (const auto& [netName, connectedCells] : netToCells) {
-        for (const auto& cellName : connectedCells) {
-            if (cellToNets[cellName].find(netName) == cellToNets[cellName].end()) {
-                std::cout << "   [ERROR] Net-Cell relationship mismatch: Net " << netName 
-                          << " connects to Cell " << cellName 
-                          << " but not vice versa" << std::endl;
-                hasConnectivityIssues = true;
-            }
-        }
+    if (netToCellPins != cellToNetPins) {
+        FM_ERROR("   [ERROR] Cell-Net relationship mismatch: ", cellToNetPins,
+                 " cell->net pins vs ", netToCellPins, " net->cell pins");
+        hasConnectivityIssues = true;
     }
     
     if (!hasConnectivityIssues) {
-        std::cout << "   - All cell-net relationships are consistent" << std::endl;
+        FM_INFO("   - All cell-net relationships are consistent");
     } else {
         isValid = false;
     }
@@ -101,112 +94,105 @@ bool validatePhase1(const Netlist& netlist, const PartitionState& partitionState
     int maxConnections = 0;
     double avgConnections = 0.0;
     
-    for (const auto& cell : netlist.getCells()) {
-        int connections = cell.netIds.size();
+    for (int cellId = 0; cellId < graph.getNumCells(); cellId++) {
+        int connections = graph.getCellDegree(cellId);
         minConnections = std::min(minConnections, connections);
         maxConnections = std::max(maxConnections, connections);
         avgConnections += connections;
     }
     
-    if (!netlist.getCells().empty()) {
-        avgConnections /= netlist.getCells().size();
+    if (graph.getNumCells() > 0) {
+        avgConnections /= graph.getNumCells();
     }
     
-    std::cout << "   - Cell connectivity statistics:" << std::endl;
-    std::cout << "     Min nets per cell: " << minConnections << std::endl;
-    std::cout << "     Max nets per cell: " << maxConnections << std::endl;
-    std::cout << "     Avg nets per cell: " << avgConnections << std::endl;
+    FM_INFO("   - Cell connectivity statistics:");
+    FM_INFO("     Min nets per cell: ", minConnections);
+    FM_INFO("     Max nets per cell: ", maxConnections);
+    FM_INFO("     Avg nets per cell: ", avgConnections);
     
     // 3. Validate initial partition
-    std::cout << "\n3. Initial Partition Validation" << std::endl;
+    FM_INFO("\n3. Initial Partition Validation");
     
     int partition0Count = partitionState.getPartitionSize(0);
     int partition1Count = partitionState.getPartitionSize(1);
     
-    std::cout << "   - Partition sizes: [" << partition0Count << ", " 
-              << partition1Count << "]" << std::endl;
+    FM_INFO("   - Partition sizes: [", partition0Count, ", ", partition1Count, "]");
               
     // Check if all cells have valid partitions
     int invalidPartitionCount = 0;
-    for (const auto& cell : netlist.getCells()) {
-        if (cell.partition != 0 && cell.partition != 1) {
+    for (int partition : cellPartitions) {
+        if (partition != 0 && partition != 1) {
             invalidPartitionCount++;
         }
     }
     
     if (invalidPartitionCount > 0) {
-        std::cout << "   [ERROR] Found " << invalidPartitionCount 
-                  << " cells with invalid partition assignments" << std::endl;
+        FM_ERROR("   [ERROR] Found ", invalidPartitionCount,
+                 " cells with invalid partition assignments");
         isValid = false;
     } else {
-        std::cout << "   - All cells have valid partition assignments" << std::endl;
+        FM_INFO("   - All cells have valid partition assignments");
     }
     
     // Verify balance constraint is met
     if (partitionState.isBalanced(partition0Count, partition1Count)) {
-        std::cout << "   - Partition satisfies balance constraint (r=" 
-                  << balanceFactor << ")" << std::endl;
+        FM_INFO("   - Partition satisfies balance constraint (r=", balanceFactor, ")");
     } else {
-        std::cout << "   [ERROR] Partition does not satisfy balance constraint (r=" 
-                  << balanceFactor << ")" << std::endl;
+        FM_ERROR("   [ERROR] Partition does not satisfy balance constraint (r=", balanceFactor,
+                 ")");
         isValid = false;
     }
     
     // Verify net partition counts
     bool netPartitionCountCorrect = true;
-    for (const auto& net : nets) {
+    int calculatedCutSize = 0;
+    for (int netId = 0; netId < graph.getNumNets(); netId++) {
         int actualPartition0Count = 0;
         int actualPartition1Count = 0;
         
-        for (int cellId : net.cellIds) {
-            const Cell* cell = netlist.getCellById(cellId);
-            if (cell) {
-                if (cell->partition == 0) actualPartition0Count++;
-                else if (cell->partition == 1) actualPartition1Count++;
-            }
+        for (int cellId : graph.getNetPins(netId)) {
+            if (cellPartitions[cellId] == 0) actualPartition0Count++;
+            else if (cellPartitions[cellId] == 1) actualPartition1Count++;
         }
         
-        if (actualPartition0Count != net.partitionCount[0] || 
-            actualPartition1Count != net.partitionCount[1]) {
-            std::cout << "   [ERROR] Net " << net.name << " has incorrect partition counts: " 
-                      << "Stored [" << net.partitionCount[0] << ", " << net.partitionCount[1] << "] " 
-                      << "Actual [" << actualPartition0Count << ", " << actualPartition1Count << "]" << std::endl;
+        const std::array<int, 2>& stored = engine.getNetPartitionCount(netId);
+        if (actualPartition0Count != stored[0] || actualPartition1Count != stored[1]) {
+            FM_ERROR("   [ERROR] Net ", graph.getNetName(netId),
+                     " has incorrect partition counts: ", "Stored [", stored[0], ", ", stored[1],
+                     "] ", "Actual [", actualPartition0Count, ", ", actualPartition1Count, "]");
             netPartitionCountCorrect = false;
         }
+        
+        // Calculate initial (weighted) cut size independently
+        if (actualPartition0Count > 0 && actualPartition1Count > 0) {
+            calculatedCutSize += graph.getNetWeight(netId);
+        }
     }
     
     if (netPartitionCountCorrect) {
-        std::cout << "   - All nets have correct partition counts" << std::endl;
+        FM_INFO("   - All nets have correct partition counts");
     } else {
         isValid = false;
     }
     
-    // Calculate initial cut size independently
-    int calculatedCutSize = 0;
-    for (const auto& net : nets) {
-        if (net.partitionCount[0] > 0 && net.partitionCount[1] > 0) {
-            calculatedCutSize++;
-        }
-    }
-    
-    std::cout << "   - Calculated initial cut size: " << calculatedCutSize << std::endl;
-    std::cout << "   - Reported initial cut size: " << partitionState.getCurrentCutSize() << std::endl;
+    FM_INFO("   - Calculated initial cut size: ", calculatedCutSize);
+    FM_INFO("   - Reported initial cut size: ", partitionState.getCurrentCutSize());
     
     if (calculatedCutSize != partitionState.getCurrentCutSize()) {
-        std::cout << "   [ERROR] Cut size mismatch" << std::endl;
+        FM_ERROR("   [ERROR] Cut size mismatch");
         isValid = false;
     }
     
-    std::cout << "\n================ VALIDATION RESULT =================" << std::endl;
-    std::cout << "Phase 1 implementation is " << (isValid ? "VALID" : "INVALID") << std::endl;
-    std::cout << "==================================================\n" << std::endl;
+    FM_INFO("\n================ VALIDATION RESULT =================");
+    FM_INFO("Phase 1 implementation is ", (isValid ? "VALID" : "INVALID"));
+    FM_INFO("==================================================\n");
     
     return isValid;
 }
 
 int main(int argc, char* argv[]) {
     // Check command line arguments
-    if (argc < 3 || argc > 4) {
+    if (argc < 3) {
         printUsage(argv[0]);
         return 1;
     }
@@ -214,59 +200,297 @@ int main(int argc, char* argv[]) {
     std::string inputFile = argv[1];
     std::string outputFile = argv[2];
     
-    // Add a command-line flag for test mode (optional)
-    bool testMode = (argc > 3 && std::string(argv[3]) == "--test");
+    // Optional flags: test mode (validate only), multilevel partitioning,
+    // parallel multi-start FM and k-way recursive bisection
+    bool testMode = false;
+    bool multilevel = false;
+    bool multiStart = false;
+    MultiStartOptions multiStartOptions;
+    MultilevelOptions multilevelOptions;
+    KWayOptions kwayOptions;
+    bool kway = false;
+    FMOptions fmOptions;
+    std::string statsFile;
+    std::string snapshotFile;
+    CellOrdering ordering = CellOrdering::NONE;
+    double timeBudget = 0.0;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--test") {
+                testMode = true;
+            } else if (arg == "--quiet") {
+                // Only warnings and errors are printed
+                fm::log::setLevel(fm::log::Level::WARNING);
+            } else if (arg == "--multilevel") {
+                multilevel = true;
+            } else if (arg == "--starts" && hasValue) {
+                multiStart = true;
+                multiStartOptions.starts = std::stoi(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                multiStartOptions.threads = std::stoi(argv[++i]);
+                fmOptions.threads = multiStartOptions.threads;
+            } else if (arg == "--seed" && hasValue) {
+                multiStartOptions.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+                multilevelOptions.seed = multiStartOptions.seed;
+            } else if (arg == "--tie-break" && hasValue) {
+                std::string mode = argv[++i];
+                if (mode == "lifo") {
+                    fmOptions.tieBreak = TieBreak::LIFO;
+                } else if (mode == "fifo") {
+                    fmOptions.tieBreak = TieBreak::FIFO;
+                } else if (mode == "random") {
+                    fmOptions.tieBreak = TieBreak::RANDOM;
+                } else {
+                    throw std::invalid_argument(mode);
+                }
+            } else if (arg == "--init" && hasValue) {
+                std::string split = argv[++i];
+                if (split == "sequential") {
+                    fmOptions.initialSplit = InitialSplit::SEQUENTIAL;
+                } else if (split == "random") {
+                    fmOptions.initialSplit = InitialSplit::RANDOM;
+                } else if (split == "bfs") {
+                    fmOptions.initialSplit = InitialSplit::BFS;
+                } else if (split == "cluster") {
+                    fmOptions.initialSplit = InitialSplit::CLUSTER;
+                } else {
+                    throw std::invalid_argument(split);
+                }
+            } else if (arg == "--reorder" && hasValue) {
+                std::string mode = argv[++i];
+                if (mode == "none") {
+                    ordering = CellOrdering::NONE;
+                } else if (mode == "bfs") {
+                    ordering = CellOrdering::BFS;
+                } else if (mode == "rcm") {
+                    ordering = CellOrdering::RCM;
+                } else {
+                    throw std::invalid_argument(mode);
+                }
+            } else if (arg == "--large-net" && hasValue) {
+                fmOptions.largeNetThreshold = std::stoi(argv[++i]);
+            } else if (arg == "--time-budget" && hasValue) {
+                timeBudget = std::stod(argv[++i]);
+            } else if (arg == "--min-rate" && hasValue) {
+                fmOptions.stop.minImprovementRate = std::stod(argv[++i]);
+            } else if (arg == "--max-passes" && hasValue) {
+                fmOptions.stop.maxPasses = std::stoi(argv[++i]);
+            } else if (arg == "--stats" && hasValue) {
+                statsFile = argv[++i];
+            } else if (arg == "--write-snapshot" && hasValue) {
+                snapshotFile = argv[++i];
+            } else if (arg == "--kway" && hasValue) {
+                kway = true;
+                kwayOptions.numBlocks = std::stoi(argv[++i]);
+            } else if (arg == "--objective" && hasValue) {
+                std::string objective = argv[++i];
+                if (objective == "cut") {
+                    kwayOptions.objective = KWayObjective::CUT;
+                } else if (objective == "km1") {
+                    kwayOptions.objective = KWayObjective::KM1;
+                } else {
+                    throw std::invalid_argument(objective);
+                }
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            FM_ERROR("Invalid value for ", arg, ": ", argv[i]);
+            return 1;
+        }
+    }
+    if (multilevel && multiStart) {
+        FM_ERROR("--multilevel and --starts cannot be combined");
+        return 1;
+    }
+    if (kway && multiStart) {
+        FM_ERROR("--kway and --starts cannot be combined");
+        return 1;
+    }
+    if (kway && !statsFile.empty()) {
+        FM_ERROR("--kway and --stats cannot be combined");
+        return 1;
+    }
+    if (kway && (kwayOptions.numBlocks < 2 ||
+                 (kwayOptions.numBlocks & (kwayOptions.numBlocks - 1)) != 0)) {
+        FM_ERROR("--kway must be a power of two of at least 2");
+        return 1;
+    }
+    if (fmOptions.largeNetThreshold < 0) {
+        FM_ERROR("--large-net must not be negative");
+        return 1;
+    }
+    if (multiStart && multiStartOptions.starts < 1) {
+        FM_ERROR("--starts must be at least 1");
+        return 1;
+    }
+    if (timeBudget < 0.0 || fmOptions.stop.minImprovementRate < 0.0 ||
+        fmOptions.stop.maxPasses < 1) {
+        FM_ERROR("--time-budget and --min-rate must not be negative, --max-passes at least 1");
+        return 1;
+    }
+    if (timeBudget > 0.0) {
+        // One deadline for the whole job, parsing included; every engine
+        // of every mode stops at it with its best partition so far
+        fmOptions.stop.deadline = StopPolicy::Clock::now() +
+            std::chrono::duration_cast<StopPolicy::Clock::duration>(
+                std::chrono::duration<double>(timeBudget));
+    }
 
     try {
-        std::cout << "Starting FM partitioning..." << std::endl;
+        FM_INFO("Starting FM partitioning...");
         
         // Initialize data structures
-        Netlist netlist;
         double balanceFactor;
+        Hypergraph graph;
 
-        // Parse input
-        std::cout << "Parsing input file: " << inputFile << std::endl;
-        Parser parser;
-        if (!parser.parseInput(inputFile, balanceFactor, netlist)) {
-            std::cerr << "Error parsing input file: " << inputFile << std::endl;
-            return 1;
+        if (Snapshot::isSnapshot(inputFile)) {
+            // Binary snapshot written by --write-snapshot: no parsing at all
+            FM_INFO("Loading snapshot: ", inputFile);
+            if (!Snapshot::load(inputFile, balanceFactor, graph)) {
+                return 1;
+            }
+        } else {
+            // Parse input. The name-keyed Netlist is only needed until the
+            // compact hypergraph has been built from it.
+            Netlist netlist;
+            FM_INFO("Parsing input file: ", inputFile);
+            Parser parser;
+            if (!parser.parseInput(inputFile, balanceFactor, netlist)) {
+                FM_ERROR("Error parsing input file: ", inputFile);
+                return 1;
+            }
+            graph = Hypergraph(netlist);
         }
-        std::cout << "Parsed input file. Balance factor: " << balanceFactor << std::endl;
-        std::cout << "Number of cells: " << netlist.getCells().size() << std::endl;
-        std::cout << "Number of nets: " << netlist.getNets().size() << std::endl;
+        FM_INFO("Parsed input file. Balance factor: ", balanceFactor);
+        if (ordering != CellOrdering::NONE) {
+            // Renumber for locality; names move with the cells, so the
+            // output is written in terms of the original names
+            auto reorderStart = std::chrono::steady_clock::now();
+            double spanBefore = meanNetSpan(graph);
+            graph = reorderHypergraph(graph, ordering);
+            FM_INFO("Reordered cells (", toString(ordering), ") in ",
+                    std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - reorderStart).count(),
+                    " ms. Mean net span: ", spanBefore, " -> ", meanNetSpan(graph));
+        }
+        if (!snapshotFile.empty()) {
+            FM_INFO("Writing snapshot: ", snapshotFile);
+            if (!Snapshot::write(snapshotFile, graph, balanceFactor)) {
+                return 1;
+            }
+        }
+        FM_INFO("Number of cells: ", graph.getNumCells());
+        FM_INFO("Number of nets: ", graph.getNumNets());
 
         // Run F-M algorithm
-        std::cout << "Running F-M algorithm..." << std::endl;
+        FM_INFO("Running F-M algorithm...");
         auto startTime = std::chrono::high_resolution_clock::now();
-        
-        FMEngine fmEngine(netlist, balanceFactor);
-        
-        // Validate Phase 1 implementation
-        validatePhase1(netlist, fmEngine.getPartitionState(), balanceFactor);
-        
-        // Only continue with full algorithm if not in test mode
+
+        if (kway) {
+            // Recursive bisection over the parsed hypergraph; each block is
+            // bisected flat or, with --multilevel, by the V-cycle
+            kwayOptions.multilevel = multilevel;
+            kwayOptions.multilevelOptions = multilevelOptions;
+            kwayOptions.multilevelOptions.fmOptions = fmOptions;
+            kwayOptions.fmOptions = fmOptions;
+            kwayOptions.fmOptions.seed = multiStartOptions.seed;
+            KWayPartitioner partitioner(graph, balanceFactor, kwayOptions);
+            partitioner.run();
+            if (testMode) {
+                return partitioner.isBalanced() ? 0 : 1;
+            }
+
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+            FM_INFO("Generating output file: ", outputFile);
+            OutputGenerator generator;
+            if (!generator.generateOutput(outputFile, graph, partitioner.getCellBlocks(),
+                                          partitioner.getNumBlocks(),
+                                          partitioner.getObjectiveName(),
+                                          partitioner.getObjectiveValue())) {
+                FM_ERROR("Error writing output file: ", outputFile);
+                return 1;
+            }
+
+            FM_INFO("Partitioning completed in ", duration.count(), " ms");
+            FM_INFO("Final cut size: ", partitioner.getCutSize(), ", connectivity - 1: ",
+                    partitioner.getConnectivity());
+            return 0;
+        }
+
+        std::unique_ptr<FMEngine> flatEngine;
+        std::unique_ptr<MultilevelPartitioner> multilevelPartitioner;
+        std::unique_ptr<MultiStartPartitioner> multiStartPartitioner;
+        const FMEngine* finalEngine = nullptr;
+        if (multilevel) {
+            // The multilevel and multi-start modes validate their final
+            // solution instead of an initial split; --test stops before
+            // writing output
+            multilevelOptions.fmOptions = fmOptions;
+            multilevelPartitioner = std::make_unique<MultilevelPartitioner>(graph, balanceFactor,
+                                                                            multilevelOptions);
+            multilevelPartitioner->run();
+            finalEngine = &multilevelPartitioner->getEngine();
+            validatePhase1(graph, *finalEngine, balanceFactor);
+        } else if (multiStart) {
+            multiStartOptions.fmOptions = fmOptions;
+            multiStartPartitioner = std::make_unique<MultiStartPartitioner>(graph, balanceFactor,
+                                                                            multiStartOptions);
+            multiStartPartitioner->run();
+            finalEngine = &multiStartPartitioner->getEngine();
+            validatePhase1(graph, *finalEngine, balanceFactor);
+        } else {
+            fmOptions.seed = multiStartOptions.seed;
+            flatEngine = std::make_unique<FMEngine>(graph, balanceFactor, fmOptions);
+
+            // Validate Phase 1 implementation
+            validatePhase1(graph, *flatEngine, balanceFactor);
+
+            // Only continue with full algorithm if not in test mode
+            if (!testMode) {
+                flatEngine->run();
+            }
+            finalEngine = flatEngine.get();
+        }
+        const FMEngine& fmEngine = *finalEngine;
+
         if (!testMode) {
-            fmEngine.run();
-            
             auto endTime = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
             // Generate output
-            std::cout << "Generating output file: " << outputFile << std::endl;
+            FM_INFO("Generating output file: ", outputFile);
             OutputGenerator generator;
-            if (!generator.generateOutput(outputFile, netlist, fmEngine.getPartitionState())) {
-                std::cerr << "Error writing output file: " << outputFile << std::endl;
+            if (!generator.generateOutput(outputFile, graph, fmEngine.getCellPartitions(),
+                                          fmEngine.getPartitionState())) {
+                FM_ERROR("Error writing output file: ", outputFile);
                 return 1;
             }
 
-            std::cout << "Partitioning completed in " << duration.count() << " ms" << std::endl;
-            std::cout << "Final cut size: " << fmEngine.getPartitionState().getCurrentCutSize() << std::endl;
+            FM_INFO("Partitioning completed in ", duration.count(), " ms");
+            FM_INFO("Final cut size: ", fmEngine.getPartitionState().getCurrentCutSize());
+
+            // Stats of the engine that produced the output (the finest level
+            // for --multilevel, the best start for --starts)
+            if (!statsFile.empty()) {
+                std::ofstream stats(statsFile);
+                if (!stats) {
+                    FM_ERROR("Error writing stats file: ", statsFile);
+                    return 1;
+                }
+                writeStatsJson(stats, fmEngine.getStats());
+            }
         }
         
         return 0;
 
     } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
+        FM_ERROR("Error: ", e.what());
         return 1;
     }
 } 
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "GateDatabase.hpp"
 #include "CircuitNode.hpp"
+#include "TimingGraph.hpp"
 
 class Circuit {
     private:
@@ -18,14 +19,50 @@ class Circuit {
         std::vector<CircuitNode*> nodes_;
         GateDatabase gate_db_;  
 
-        double totalCircuitDelay;
+        // Library of every corner analyzed, starting with gate_db_, and the file
+        // each one was read from. The libraries after gate_db_ are owned here
+        std::vector<GateDatabase*> corner_dbs_;
+        std::vector<std::string> corner_names_;
+
+        // Latest arrival at an output in every corner
+        CornerTiming totalCircuitDelay;
+
+        // Flat timing view of nodes_, where all analysis results live
+        TimingGraph timing_graph_;
+
+        // Dense indices of the nodes touched by edits since the last timing
+        // update, whose arrival or required time has to be recomputed
+        std::vector<NodeID> dirty_arrival_;
+        std::vector<NodeID> dirty_required_;
+
+        // Loop check scratch for add_fanout, kept between edits so a check
+        // costs the nodes it visits: a node counts as visited when its stamp
+        // equals the current epoch
+        std::vector<unsigned int> visit_stamp_;
+        unsigned int visit_epoch_ = 0;
 
         // Resizes the nodes_ vector to fit the node_id
         void allocate_for_node_id(const NodeID& node_id);
 
         Circuit(const std::string& ckt_file, const std::string& lib_file);
+        // One corner per library. The netlist's gates are looked up in the first,
+        // and a library missing any of its cells is left out with an error
+        Circuit(const std::string& ckt_file, const std::vector<std::string>& lib_files);
         ~Circuit();
 
+        // What-if edits on an analyzed circuit. Each one returns false and leaves
+        // the circuit untouched if the edit is not valid. The timing is brought
+        // up to date by the next update_timing(). An edit costs the degrees of
+        // the nodes it touches plus the fanout cone it relevels; add_fanout's
+        // loop check also walks the sink's fanout below the driver's level
+        bool change_gate_type(const NodeID& node_id, const std::string& gate_type);
+        bool add_fanout(const NodeID& driver_id, const NodeID& sink_id);
+        bool remove_fanout(const NodeID& driver_id, const NodeID& sink_id);
+
+        // Re-times only the cones of the edits since the last update, after
+        // which findCriticalPath reports the new critical path
+        void update_timing();
+
         void print_node_info(const NodeID& node_id);
         void test();
 };
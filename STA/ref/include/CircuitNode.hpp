@@ -25,20 +25,6 @@ class CircuitNode {
         int outDegree; // number of gates connected to the output of this particular gate
 
 
-
-        std::vector<double> inputArrivalTimes; // input arrival times for each input to the gate
-        std::vector<double> outputArrivalTimes; // using the input arrival time vector we determin the ouptput arrival time for each input
-        std::vector<double> gateDelays;
-        std::vector<double> inputSlews; // input slews for each input to the gate
-        std::vector<double> outputSlews; // output slews for each output to the gate
-        double outputLoad; // capacitance of all the gates connected to this gates outputs' summed together
-        double gateSlack; // use backwards traversal to aquire for each gate
-        double slewOut; // actual output slew time from maxamizing the output vector 
-        double timeOut; // Actual output time from maximizing the output vector
-        double requiredArrivalTime;
-        double cellDelay;
-
-
         // constructers
         CircuitNode() :
             node_id_(-1), 
@@ -51,22 +37,8 @@ class CircuitNode {
             fanout_list(),
 
             inDegree(0),
-            outDegree(0),
-
-            inputArrivalTimes(),
-            outputArrivalTimes(),
-            gateDelays(),
-            inputSlews(),
-            outputSlews(),
-
-            outputLoad(0),
-            gateSlack(0),           
-            slewOut(0),
-            timeOut(0),
+            outDegree(0)
 
-            requiredArrivalTime(0),
-            cellDelay(0)
-            
             { }
         
         void set_node_id(const NodeID& node_id);
@@ -15,8 +15,44 @@ struct GateInfo {
     double output_slewindex2[GATE_LUT_DIM];
     double cell_delay[GATE_LUT_DIM][GATE_LUT_DIM];
     double output_slew[GATE_LUT_DIM][GATE_LUT_DIM];
+    // Set on insert when both tables use the same index_1/index_2 axes,
+    // so one bracket search serves both lookups
+    bool shared_axes;
 };
 
+// Delay and output slew of a gate for one input slew / load pair
+struct GateTiming {
+    double delay;
+    double slew;
+};
+
+// Bilinear interpolation of both the cell_delay and output_slew tables.
+// Points outside the table are extrapolated from the nearest edge interval.
+GateTiming interpolate_gate_timing(const GateInfo* gate_info, double input_slew, double load_capacitance);
+
+// Most library corners analyzed together. Each corner is one lane of a
+// CornerTiming, so the corners of a gate are interpolated with SIMD in one go
+#define MAX_CORNERS 4
+
+typedef double CornerTiming __attribute__((vector_size(MAX_CORNERS * sizeof(double))));
+
+// The same cell in the library of every corner. Lanes past the last corner
+// have no cell and zero capacitance
+struct CornerGateInfo {
+    CornerTiming capacitance;
+    const GateInfo* corner[MAX_CORNERS];
+};
+
+struct CornerGateTiming {
+    CornerTiming delay;
+    CornerTiming slew;
+};
+
+// interpolate_gate_timing for the first num_corners lanes at once. The
+// remaining lanes come out finite but meaningless. One corner goes through
+// interpolate_gate_timing itself
+CornerGateTiming interpolate_corner_timing(const CornerGateInfo& gate_info, int num_corners, const CornerTiming& input_slew, const CornerTiming& load_capacitance);
+
 class GateDatabase {
     private:
         // Stores the pointer to the GateInfo. Indexed using the name of gate
@@ -0,0 +1,52 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data parallel loops. The calling thread
+// takes part in every loop, so a pool of size 1 has no workers and runs
+// everything inline.
+class ThreadPool {
+    public:
+        // Body of a parallel loop, called with a [begin, end) chunk
+        typedef std::function<void(size_t, size_t)> RangeFunction;
+
+        explicit ThreadPool(unsigned int num_threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned int size() const;
+
+        // Splits [0, count) into chunks of at least min_chunk items, runs fn
+        // on them across the pool and returns once all chunks are done.
+        // Small loops run inline on the caller.
+        void parallel_for(size_t count, size_t min_chunk, const RangeFunction& fn);
+
+    private:
+        void worker_loop();
+        void run_chunks();
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable work_done_;
+
+        // Current loop, published under mutex_ by bumping generation_
+        const RangeFunction* job_;
+        size_t job_count_;
+        size_t job_chunk_;
+        std::atomic<size_t> next_index_;
+        unsigned long generation_;
+        unsigned int busy_workers_;
+        bool stopping_;
+};
+
+#endif //THREADPOOL_HPP
@@ -0,0 +1,112 @@
+#ifndef TIMING_HPP
+#define TIMING_HPP
+
+#include <vector>
+#include <limits>
+
+#include "Circuit.hpp"
+#include "ThreadPool.hpp"
+#include "TimingGraph.hpp"
+
+// Print progress and intermediate values while analyzing
+extern bool debug;
+
+// One node along a timing path, with the arc that reaches it from the node before
+struct TimingPathNode {
+    CircuitNode* node;
+    double delay;       // gate delay through the arc into the node, 0 at the start of the path
+    double arrival;     // arrival time at the node's output along this path
+    double slew;        // output slew when the node switches through this arc
+};
+
+// A path from an input to an output, with its slack against the output's required time
+struct TimingPath {
+    std::vector<TimingPathNode> nodes;  // from the input to the output
+    double delay;
+    double slack;
+};
+
+/**
+ * Converts all DFFs in a circuit to act as a simulatenous input and output
+ * @param circuit Circuit to execute the function on
+ */
+void convertDFFs(Circuit &circuit);
+/**
+ * Populates the fanout lists for each node and an integer to store number of inputs and outputs
+ * @param circuit Circuit to execute the function on
+ */
+void createFanOutLists(Circuit &circuit);
+/**
+ * Levelize the circuit and compile it into its flat timing graph, with the inputs on level 0 and every gate one level
+ * above its deepest fanin
+ * @param circuit the circuit to compile, after createFanOutLists
+ */
+void compileTimingGraph(Circuit &circuit);
+/**
+ * Traverse the graph forward level by level to find the arrival time at each of the gates
+ * @param circuit the circuit to find the arrival time at each gate of
+ * @param pool the threads each level is split across
+ */
+void runForwardTraversal(Circuit &circuit, ThreadPool &pool);
+/**
+ * Given a node whose fanins are done, find its output load, then the pin delays, arrival time and slew at that node
+ * @param graph the timing graph the node exists in
+ * @param node dense index of the node to find arrival time at
+ * @param outputPadLoad load seen by an output with nothing connected to it, in every corner
+ */
+void findNodeArrival(TimingGraph &graph, int node, const CornerTiming &outputPadLoad);
+/**
+ * Given a node whose fanouts are done, find the required time and slack at that node
+ * @param graph the timing graph the node exists in
+ * @param node dense index of the node to find the required time at
+ * @param requiredTime the required time at the circuit outputs, in every corner
+ */
+void findNodeRequiredTime(TimingGraph &graph, int node, const CornerTiming &requiredTime);
+/**
+ * Traverse the graph backward level by level to find the slack at each of the gates
+ * @param circuit the circuit to the find the slack at each gate of
+ * @param pool the threads each level is split across
+ */
+void runBackwardTraversal (Circuit &circuit, ThreadPool &pool);
+/**
+ * Re-time the parts of an analyzed circuit touched by edits since the last update. Arrival times are
+ * re-propagated through the fanout cone of each edit and required times through the fanin cone, stopping
+ * wherever a node's values come out unchanged. The result matches a full forward and backward traversal
+ * @param circuit the circuit holding the pending edits
+ */
+void runIncrementalTraversal(Circuit &circuit);
+/**
+ * Recompute the level of a node from its fanins after its fanin list changed, moving every node in its
+ * fanout cone whose level changes with it
+ * @param graph the timing graph the node exists in
+ * @param node dense index of the node whose fanins changed
+ */
+void relevelFanoutCone(TimingGraph &graph, int node);
+/**
+ * Find the smallest slack at any output of an analyzed circuit
+ * @param circuit the analyzed circuit
+ * @param corner the library corner to take the slacks of
+ * @return returns the worst output slack
+ */
+double findWorstSlack (Circuit &circuit, int corner);
+/**
+ * Find the critical path in a graph, i.e. path with the minimum slews
+ * @param circuit the circuit to run the function on
+ * @param corner the library corner to follow the slacks of
+ * @return returns a vector containing the nodes along the critical path
+ */
+std::vector <CircuitNode*> findCriticalPath (Circuit &circuit, int corner = 0);
+/**
+ * Enumerate the worst paths of an analyzed circuit in order of increasing slack, with the delay and slew of every
+ * arc along them. Paths are searched best first back from the outputs, using each node's arrival time as the exact
+ * delay still ahead, so only paths that end up reported get expanded
+ * @param circuit the analyzed circuit to find the paths in
+ * @param maxPaths most paths to return
+ * @param maxSlack only paths with at most this slack are returned
+ * @param maxPathsPerEndpoint most paths to return ending at any one output, 0 for no limit
+ * @param corner the library corner to time the paths in
+ * @return returns the worst paths, the worst one first
+ */
+std::vector <TimingPath> findWorstPaths (Circuit &circuit, unsigned int maxPaths, double maxSlack = std::numeric_limits<double>::max(), unsigned int maxPathsPerEndpoint = 0, int corner = 0);
+
+#endif //TIMING_HPP
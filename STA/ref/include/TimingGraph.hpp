@@ -0,0 +1,103 @@
+#ifndef TIMINGGRAPH_HPP
+#define TIMINGGRAPH_HPP
+
+#include <vector>
+
+#include "GateDatabase.hpp"
+#include "CircuitNode.hpp"
+
+// Timing view of a circuit compiled into flat arrays. Nodes get dense
+// indices in level order, edges are stored CSR style, and every timing value
+// lives in one contiguous per-node or per-pin array sized when the graph is
+// built. A pin is a position in fanin_, so pin p of node i is
+// fanin_start_[i] + p. Every timing value holds one lane per library corner.
+// Rows are packed when the graph is built; an edge edit only touches the
+// rows of its two nodes, moving a full row to the end of the arrays with
+// room to spare, so edits cost O(degree) rather than O(circuit).
+class TimingGraph {
+    private:
+        // End of the room reserved for the fanin and fanout row of every node
+        std::vector<int> fanin_limit_;
+        std::vector<int> fanout_limit_;
+
+        // Moves a full row to the end of the arrays with twice its room. The
+        // old slots stay unused until the graph is built again
+        void grow_fanin_row(int node);
+        void grow_fanout_row(int node);
+
+    public:
+        // Dense index of every ISCAS node ID, -1 where there is no node
+        std::vector<int> index_of_;
+        // ISCAS node ID of every dense index
+        std::vector<NodeID> node_id_;
+
+        // Library corners analyzed, each one lane of the timing values
+        int num_corners_;
+
+        // Cell of every gate in each corner's library, empty for inputs
+        std::vector<CornerGateInfo> gate_info_;
+        std::vector<char> input_pad_;
+        std::vector<char> output_pad_;
+
+        // The drivers of node i are fanin_[fanin_start_[i] .. fanin_end_[i]),
+        // the nodes it drives are fanout_[fanout_start_[i] .. fanout_end_[i])
+        std::vector<int> fanin_start_;
+        std::vector<int> fanin_end_;
+        std::vector<int> fanin_;
+        std::vector<int> fanout_start_;
+        std::vector<int> fanout_end_;
+        std::vector<int> fanout_;
+        // Which input pin of fanout_[e] fanout edge e drives, counted from 0
+        std::vector<int> fanout_pin_;
+
+        // Topological level of every node, 0 for inputs and -1 if no input reaches it
+        std::vector<int> level_;
+        // Dense indices grouped by level, and where each node sits in its level
+        std::vector<std::vector<int>> levels_;
+        std::vector<int> level_slot_;
+        // Dense indices of the output pads, in node ID order
+        std::vector<int> outputs_;
+
+        // Per node timing
+        std::vector<CornerTiming> load_;              // capacitance driven by the node
+        std::vector<CornerTiming> arrival_;           // latest arrival time at the output
+        std::vector<CornerTiming> slew_;              // output slew of the latest arrival
+        std::vector<CornerTiming> cell_delay_;        // gate delay along the latest arrival
+        std::vector<CornerTiming> downstream_delay_;  // longest delay from the output to a constrained output
+        std::vector<CornerTiming> required_;
+        std::vector<CornerTiming> slack_;
+        std::vector<char> required_known_;
+
+        // Per pin timing: gate delay from that input to the output, and the
+        // output slew when the output switches from that input
+        std::vector<CornerTiming> pin_delay_;
+        std::vector<CornerTiming> pin_slew_;
+
+        // Levelizes the nodes and compiles them, after the fanout lists exist,
+        // taking each gate's cell from the library of every corner. All timing
+        // values start at 0
+        void build(const std::vector<CircuitNode*>& nodes, const std::vector<GateDatabase*>& corner_dbs);
+
+        int num_nodes() const;
+        int num_fanins(int node) const;
+        int num_fanouts(int node) const;
+
+        // Position in fanin_ and pin_delay_ of the pin fanout edge e drives
+        int sink_pin(int edge) const;
+        // Gate delay through the pin fanout edge e drives
+        const CornerTiming& arc_delay(int edge) const;
+        // First fanout edge from driver to sink, -1 if there is none
+        int find_edge(int driver, int sink) const;
+        // Fanout edge from driver to sink with the latest arrival through its
+        // pin in the given corner, -1 if there is none. A sink can take the same
+        // driver on several pins, which then differ only in their gate delay
+        int latest_edge(int driver, int sink, int corner) const;
+
+        // Adds driver as the last input pin of sink, or removes the first pin of
+        // sink driven by driver. Levels are not touched. Both take time linear
+        // in the degrees of driver and sink
+        void add_edge(int driver, int sink);
+        void remove_edge(int driver, int sink);
+};
+
+#endif //TIMINGGRAPH_HPP
@@ -0,0 +1,28 @@
+make incremental_test || exit 1
+
+PRG_NAME=./incremental_test
+TEST_LIB_PATH="./test/NLDM_lib_max2Inp"
+TEST_CKT_PATH="./test/cleaned_iscas89_99_circuits"
+
+failed=0
+
+run_test() {
+    local circuit_name=$1
+    local circuit_file=$2
+    local num_edits=$3
+
+    echo "==========================================="
+    echo "Testing ${circuit_name}"
+    echo ""
+
+    # Random edits, each followed by an incremental update and a full analysis
+    $PRG_NAME $TEST_LIB_PATH "$circuit_file" -edits "$num_edits" || failed=1
+}
+
+run_test "c17" "${TEST_CKT_PATH}/c17.isc" 200
+run_test "c1908" "${TEST_CKT_PATH}/c1908_.isc" 200
+run_test "c7552" "${TEST_CKT_PATH}/c7552.isc" 200
+run_test "b15" "${TEST_CKT_PATH}/b15_1.isc" 50
+run_test "b19" "${TEST_CKT_PATH}/b19_1.isc" 20
+
+exit $failed
@@ -1,56 +1,212 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <regex>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "Circuit.hpp"
+#include "Timing.hpp"
 
 #define NODE_BUF_SIZE 1000
 
 using namespace std;
 
+namespace {
+
+// Read-only mapping of a whole file, so the netlist is scanned in place
+class MappedFile {
+    public:
+        explicit MappedFile(const std::string& file_name) : data_(nullptr), size_(0), is_open_(false) {
+            int fd = open(file_name.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) == 0) {
+                size_ = file_stat.st_size;
+                if (size_ == 0) {
+                    is_open_ = true;
+                } else {
+                    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping != MAP_FAILED) {
+                        data_ = static_cast<const char*>(mapping);
+                        is_open_ = true;
+                        madvise(mapping, size_, MADV_SEQUENTIAL);
+                    }
+                }
+            }
+            close(fd);
+        }
+
+        ~MappedFile() {
+            if (data_ != nullptr)
+                munmap(const_cast<char*>(data_), size_);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool is_open() const { return is_open_; }
+        const char* begin() const { return data_; }
+        const char* end() const { return data_ + size_; }
+
+    private:
+        const char* data_;
+        size_t size_;
+        bool is_open_;
+};
+
+// Reads the run of digits at pos into node_id and moves pos past it.
+// False if pos is not at a digit
+bool parse_node_id(const char*& pos, const char* end, NodeID& node_id) {
+    if (pos == end || !isdigit((unsigned char) *pos))
+        return false;
+
+    long value = 0;
+    while (pos != end && isdigit((unsigned char) *pos)) {
+        value = value * 10 + (*pos - '0');
+        pos++;
+    }
+    node_id = (NodeID) value;
+    return true;
+}
+
+// <prefix><nodeNumber>) filling the whole line, e.g. INPUT(12)
+bool match_pad(const char* pos, const char* end, const char* prefix, NodeID& node_id) {
+    size_t prefix_len = strlen(prefix);
+    if ((size_t) (end - pos) < prefix_len + 2 || memcmp(pos, prefix, prefix_len) != 0 || end[-1] != ')')
+        return false;
+
+    pos += prefix_len;
+    return parse_node_id(pos, end, node_id) && pos == end - 1;
+}
+
+bool is_gate_name_char(char c) {
+    return isalnum((unsigned char) c) || c == '_';
+}
+
+// <nodeNumber>=<GATE>(<digits and commas>) filling the whole line. On a
+// match fanin_begin points just past the opening bracket
+bool match_gate(const char* pos, const char* end, NodeID& node_id, std::string& gate_type, const char*& fanin_begin) {
+    if (!parse_node_id(pos, end, node_id) || pos == end || *pos != '=')
+        return false;
+    pos++;
+
+    const char* name_begin = pos;
+    while (pos != end && is_gate_name_char(*pos))
+        pos++;
+    if (pos == name_begin || pos == end || *pos != '(')
+        return false;
+    gate_type.assign(name_begin, pos);
+    pos++;
+
+    fanin_begin = pos;
+    if (end - pos < 2 || end[-1] != ')')
+        return false;
+    for (const char* c = pos; c < end - 1; c++) {
+        if (!isdigit((unsigned char) *c) && *c != ',')
+            return false;
+    }
+    return true;
+}
+
+// Checks that node_id names a node that the last analysis reached
+bool is_timed_node(const std::vector<CircuitNode*>& nodes, const TimingGraph& graph, const NodeID& node_id) {
+    if (node_id < 0 || node_id >= (NodeID) nodes.size() || nodes[node_id] == nullptr) {
+        cout << "Invalid Node ID: " << node_id << endl;
+        return false;
+    }
+    if (node_id >= (NodeID) graph.index_of_.size() || graph.level_[graph.index_of_[node_id]] < 0) {
+        cout << "Node " << node_id << " has no timing, analyze the circuit first" << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
 Circuit::Circuit(const std::string& ckt_file, const std::string& lib_file):
+        Circuit(ckt_file, std::vector<std::string>(1, lib_file)) {
+}
+
+Circuit::Circuit(const std::string& ckt_file, const std::vector<std::string>& lib_files):
         // Call the constructor of GateDatabase
-        gate_db_(lib_file) {
-    
+        gate_db_(lib_files[0]),
+        corner_dbs_(1, &gate_db_),
+        corner_names_(1, lib_files[0]) {
+
+    for (unsigned int corner = 1; corner < lib_files.size(); corner++) {
+        if (corner_dbs_.size() == MAX_CORNERS) {
+            cout << "Error: At most " << MAX_CORNERS << " corners are supported, ignoring " << lib_files[corner] << endl;
+            continue;
+        }
+
+        GateDatabase* corner_db = new GateDatabase(lib_files[corner]);
+        string missing_cell;
+        for (const auto& key_value : gate_db_.gate_info_lut_) {
+            if (corner_db->get_gate_info(key_value.first) == nullptr) {
+                missing_cell = key_value.first;
+                break;
+            }
+        }
+
+        if (!missing_cell.empty()) {
+            cout << "Error: Library " << lib_files[corner] << " has no cell " << missing_cell << ", ignoring it" << endl;
+            delete corner_db;
+            continue;
+        }
+
+        corner_dbs_.push_back(corner_db);
+        corner_names_.push_back(lib_files[corner]);
+    }
+
     // cout << "Parsing circuit file: " << ckt_file << endl;
-    ifstream ifs(ckt_file.c_str());
-    if (!ifs.is_open()) {
+    MappedFile file(ckt_file);
+    if (!file.is_open()) {
         cout << "Error opening file " << ckt_file << endl;
         return;
     }
 
     nodes_.reserve(NODE_BUF_SIZE);
 
-    const regex input_pad_regex("INPUT\\((\\d+)\\)");
-    const regex output_pad_regex("OUTPUT\\((\\d+)\\)");
-    const regex node_regex("(\\d+)=([a-zA-Z0-9_]+)\\(([0-9,\\s]+)\\)");
+    // One line at a time with all whitespace removed, reusing the buffer
+    string code_line;
+    string gate_type;
+    const char* cursor = file.begin();
+    const char* file_end = file.end();
 
-    smatch output_pad_regex_match;
-    smatch input_pad_regex_match;
-    smatch node_regexMatch;
-
-    while (ifs.good()) {
-        string line;
-        getline(ifs, line);
+    while (cursor < file_end) {
+        const char* line_end = static_cast<const char*>(memchr(cursor, '\n', file_end - cursor));
+        if (line_end == nullptr)
+            line_end = file_end;
 
         // We only need to parse before the comment
-        string code_line = line.substr(0, line.find("#"));
+        const char* code_end = static_cast<const char*>(memchr(cursor, '#', line_end - cursor));
+        if (code_end == nullptr)
+            code_end = line_end;
 
-        // Remove all whitespace to make regex simpler
-        code_line.erase(remove_if(code_line.begin(), code_line.end(), ::isspace), code_line.end());
+        // Remove all whitespace to make parsing simpler
+        code_line.clear();
+        for (const char* c = cursor; c < code_end; c++) {
+            if (!isspace((unsigned char) *c))
+                code_line.push_back(*c);
+        }
+        cursor = line_end + 1;
 
         if (code_line.length() <= 0)
             continue;
 
-        // cout << code_line << endl;
+        const char* pos = code_line.data();
+        const char* end = pos + code_line.size();
+        NodeID node_id;
 
         // Find INPUT(<nodeNumber>)
-        regex_match(code_line, input_pad_regex_match, input_pad_regex);
-        if (input_pad_regex_match.size() > 0) {
-            NodeID node_id = stoi(input_pad_regex_match[1]);            
+        if (match_pad(pos, end, "INPUT(", node_id)) {
             allocate_for_node_id(node_id);
             nodes_[node_id]->set_node_id(node_id);
             nodes_[node_id]->set_input_pad(true);
@@ -58,20 +214,16 @@ Circuit::Circuit(const std::string& ckt_file, const std::string& lib_file):
         }
 
         // Find OUTPUT(<nodeNumber>)
-        regex_match(code_line, output_pad_regex_match, output_pad_regex);
-        if (output_pad_regex_match.size() > 0) {
-            NodeID node_id = stoi(output_pad_regex_match[1]);            
+        if (match_pad(pos, end, "OUTPUT(", node_id)) {
             allocate_for_node_id(node_id);
             nodes_[node_id]->set_node_id(node_id);
             nodes_[node_id]->set_output_pad(true);
             continue;
         }
 
-        // Find <nodeNumber>=(<nodeNumber...>)
-        regex_match(code_line, node_regexMatch, node_regex);
-        if (node_regexMatch.size() > 0) {
-            NodeID node_id = stoi(node_regexMatch[1]);
-            string gate_type = node_regexMatch[2];
+        // Find <nodeNumber>=<GATE>(<nodeNumber>,...)
+        const char* fanin_begin;
+        if (match_gate(pos, end, node_id, gate_type, fanin_begin)) {
             transform(gate_type.begin(), gate_type.end(), gate_type.begin(), ::toupper);
             allocate_for_node_id(node_id);
 
@@ -79,12 +231,13 @@ Circuit::Circuit(const std::string& ckt_file, const std::string& lib_file):
             nodes_[node_id]->set_gate_type(gate_type);
             nodes_[node_id]->set_gate_info(gate_db_.get_gate_info(gate_type));
 
-            stringstream node_ids_str(node_regexMatch[3]);
+            // Numbers separated by single delimiters, up to the closing bracket
+            const char* fanin_end = end - 1;
             NodeID input_node_id;
-            char delim;
-            while (node_ids_str >> input_node_id) {
+            while (fanin_begin < fanin_end && parse_node_id(fanin_begin, fanin_end, input_node_id)) {
                 nodes_[node_id]->add_to_fanin_list(input_node_id);
-                node_ids_str >> delim;
+                if (fanin_begin < fanin_end)
+                    fanin_begin++;
             }
             continue;
         }
@@ -92,6 +245,9 @@ Circuit::Circuit(const std::string& ckt_file, const std::string& lib_file):
 }
 
 Circuit::~Circuit() {
+    for (unsigned int corner = 1; corner < corner_dbs_.size(); corner++)
+        delete corner_dbs_[corner];
+
     for(const auto& node_ptr: nodes_) {
         if (node_ptr != nullptr)
             delete node_ptr;
@@ -121,6 +277,130 @@ void Circuit::allocate_for_node_id(const NodeID& node_id) {
     }
 }
 
+bool Circuit::change_gate_type(const NodeID& node_id, const std::string& gate_type) {
+    if (!is_timed_node(nodes_, timing_graph_, node_id))
+        return false;
+
+    CircuitNode* node = nodes_[node_id];
+    if (node->is_input_pad()) {
+        cout << "Node " << node_id << " is an input and has no gate type" << endl;
+        return false;
+    }
+
+    string upper_gate_type = gate_type;
+    transform(upper_gate_type.begin(), upper_gate_type.end(), upper_gate_type.begin(), ::toupper);
+    CornerGateInfo corner_gate_info = CornerGateInfo();
+    for (unsigned int corner = 0; corner < corner_dbs_.size(); corner++) {
+        const GateInfo* gate_info = corner_dbs_[corner]->get_gate_info(upper_gate_type);
+        if (gate_info == nullptr) {
+            cout << "Gate type " << gate_type << " is not in the library " << corner_names_[corner] << endl;
+            return false;
+        }
+        corner_gate_info.corner[corner] = gate_info;
+        corner_gate_info.capacitance[corner] = gate_info->capacitance;
+    }
+
+    node->set_gate_type(upper_gate_type);
+    node->set_gate_info(corner_gate_info.corner[0]);
+
+    int index = timing_graph_.index_of_[node_id];
+    timing_graph_.gate_info_[index] = corner_gate_info;
+
+    // The gate's own delays change, and so does the load on everything driving it
+    dirty_arrival_.push_back(index);
+    for (NodeID fanin_id : node->fanin_list_)
+        dirty_arrival_.push_back(timing_graph_.index_of_[fanin_id]);
+    return true;
+}
+
+bool Circuit::add_fanout(const NodeID& driver_id, const NodeID& sink_id) {
+    if (!is_timed_node(nodes_, timing_graph_, driver_id) || !is_timed_node(nodes_, timing_graph_, sink_id))
+        return false;
+
+    CircuitNode* driver = nodes_[driver_id];
+    CircuitNode* sink = nodes_[sink_id];
+    if (sink->is_input_pad()) {
+        cout << "Node " << sink_id << " is an input and can't be driven" << endl;
+        return false;
+    }
+
+    int driver_index = timing_graph_.index_of_[driver_id];
+    int sink_index = timing_graph_.index_of_[sink_id];
+
+    // Levels only grow along edges, so the sink can only reach the driver
+    // through nodes below the driver's level
+    if ((int) visit_stamp_.size() != timing_graph_.num_nodes() || ++visit_epoch_ == 0) {
+        visit_stamp_.assign(timing_graph_.num_nodes(), 0);
+        visit_epoch_ = 1;
+    }
+    vector<int> stack(1, sink_index);
+    bool creates_loop = false;
+    while (!stack.empty() && !creates_loop) {
+        int node = stack.back();
+        stack.pop_back();
+        if (node == driver_index) {
+            creates_loop = true;
+        } else if (timing_graph_.level_[node] < timing_graph_.level_[driver_index] && visit_stamp_[node] != visit_epoch_) {
+            visit_stamp_[node] = visit_epoch_;
+            stack.insert(stack.end(), timing_graph_.fanout_.begin() + timing_graph_.fanout_start_[node],
+                         timing_graph_.fanout_.begin() + timing_graph_.fanout_end_[node]);
+        }
+    }
+    if (creates_loop) {
+        cout << "Connecting " << driver_id << " to " << sink_id << " would create a loop" << endl;
+        return false;
+    }
+
+    sink->add_to_fanin_list(driver_id);
+    sink->inDegree += 1;
+    driver->fanout_list.push_back(sink_id);
+    driver->outDegree += 1;
+    timing_graph_.add_edge(driver_index, sink_index);
+    relevelFanoutCone(timing_graph_, sink_index);
+
+    // The sink gains an input, the driver gains load and a new path to the outputs
+    dirty_arrival_.push_back(sink_index);
+    dirty_arrival_.push_back(driver_index);
+    dirty_required_.push_back(driver_index);
+    return true;
+}
+
+bool Circuit::remove_fanout(const NodeID& driver_id, const NodeID& sink_id) {
+    if (!is_timed_node(nodes_, timing_graph_, driver_id) || !is_timed_node(nodes_, timing_graph_, sink_id))
+        return false;
+
+    CircuitNode* driver = nodes_[driver_id];
+    CircuitNode* sink = nodes_[sink_id];
+    vector<NodeID>::iterator fanin = find(sink->fanin_list_.begin(), sink->fanin_list_.end(), driver_id);
+    if (fanin == sink->fanin_list_.end()) {
+        cout << "Node " << driver_id << " does not drive " << sink_id << endl;
+        return false;
+    }
+    if (sink->fanin_list_.size() == 1) {
+        cout << "Node " << sink_id << " would be left without inputs" << endl;
+        return false;
+    }
+
+    sink->fanin_list_.erase(fanin);
+    sink->inDegree -= 1;
+    driver->fanout_list.erase(find(driver->fanout_list.begin(), driver->fanout_list.end(), sink_id));
+    driver->outDegree -= 1;
+
+    int driver_index = timing_graph_.index_of_[driver_id];
+    int sink_index = timing_graph_.index_of_[sink_id];
+    timing_graph_.remove_edge(driver_index, sink_index);
+    relevelFanoutCone(timing_graph_, sink_index);
+
+    dirty_arrival_.push_back(sink_index);
+    dirty_arrival_.push_back(driver_index);
+    dirty_required_.push_back(driver_index);
+    return true;
+}
+
+void Circuit::update_timing() {
+    runIncrementalTraversal(*this);
+}
+
 void Circuit::print_node_info(const NodeID& node_id) {
     if (node_id >= (NodeID) nodes_.size()) {
         cout << "Invalid Node ID: " << node_id << endl;
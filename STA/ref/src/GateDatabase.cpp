@@ -1,12 +1,34 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <regex>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
 
 #include "GateDatabase.hpp"
 
 using namespace std;
 
+namespace {
+
+// cell(<gate_name>) at the start of a line with whitespace removed
+bool match_cell(const std::string& line, std::string& gate_name) {
+    const size_t prefix_len = 5;
+    if (line.compare(0, prefix_len, "cell(") != 0)
+        return false;
+
+    size_t name_end = prefix_len;
+    while (name_end < line.size() && (isalnum((unsigned char) line[name_end]) || line[name_end] == '_'))
+        name_end++;
+    if (name_end == line.size() || line[name_end] != ')')
+        return false;
+
+    gate_name = line.substr(prefix_len, name_end - prefix_len);
+    return true;
+}
+
+} // namespace
+
 GateDatabase::GateDatabase(const std::string& file_name) {
     // cout << "Parsing database file: " << file_name << endl;
 
@@ -49,21 +71,16 @@ GateDatabase::GateDatabase(const std::string& file_name) {
 
     GateInfo* gate_info = nullptr;
 
-    const regex cell_regex("cell\\(([a-zA-Z0-9_]*)\\).*");
-    smatch cell_regex_match;
-
     while (ifs.good()) {
         string line;
         getline(ifs, line);
 
-        // Remove all whitespace to make regex and parsing simpler
+        // Remove all whitespace to make parsing simpler
         line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
 
         if (!found.cell) {
             // Find cell(<gate_name>)
-            regex_match(line, cell_regex_match, cell_regex);
-            if (cell_regex_match.size() > 0) {
-                gate_name = cell_regex_match[1];
+            if (match_cell(line, gate_name)) {
                 gate_info = new GateInfo;
                 found.cell = true;
             }
@@ -232,6 +249,9 @@ GateDatabase::~GateDatabase() {
 }
 
 void GateDatabase::insert(const std::string& gate_name, GateInfo* gate_info) {
+    gate_info->shared_axes =
+        memcmp(gate_info->cell_delayindex1, gate_info->output_slewindex1, sizeof(gate_info->cell_delayindex1)) == 0 &&
+        memcmp(gate_info->cell_delayindex2, gate_info->output_slewindex2, sizeof(gate_info->cell_delayindex2)) == 0;
     gate_info_lut_.insert({gate_name, gate_info});
 }
 
@@ -246,6 +266,154 @@ const GateInfo* GateDatabase::get_gate_info(const std::string& gate_name) {
     return nullptr;
 }
 
+namespace {
+
+// Lower index of the axis interval holding value, clamped to the first and
+// last interval. Counting the interior points below value gives the first
+// interval with axis[i] <= value <= axis[i+1] without a data dependent branch.
+inline int find_bracket(const double* axis, double value) {
+    int index = 0;
+    for (int i = 1; i < GATE_LUT_DIM - 1; i++) {
+        index += axis[i] < value;
+    }
+    return index;
+}
+
+// Interpolation weights for one (slew, load) point within its bracket
+struct LutWeights {
+    int slew_index;
+    int cap_index;
+    double c2_minus_c;
+    double c_minus_c1;
+    double t2_minus_t;
+    double t_minus_t1;
+    double area;
+};
+
+inline LutWeights make_weights(const double* slew_axis, const double* cap_axis, double input_slew, double load_capacitance) {
+    LutWeights w;
+    w.slew_index = find_bracket(slew_axis, input_slew);
+    w.cap_index = find_bracket(cap_axis, load_capacitance);
+
+    double T1 = slew_axis[w.slew_index];
+    double T2 = slew_axis[w.slew_index + 1];
+    double C1 = cap_axis[w.cap_index];
+    double C2 = cap_axis[w.cap_index + 1];
+
+    w.c2_minus_c = C2 - load_capacitance;
+    w.c_minus_c1 = load_capacitance - C1;
+    w.t2_minus_t = T2 - input_slew;
+    w.t_minus_t1 = input_slew - T1;
+    w.area = (C2 - C1) * (T2 - T1);
+    return w;
+}
+
+inline double interpolate(const double table[GATE_LUT_DIM][GATE_LUT_DIM], const LutWeights& w) {
+    double V11 = table[w.slew_index][w.cap_index];
+    double V12 = table[w.slew_index][w.cap_index + 1];
+    double V21 = table[w.slew_index + 1][w.cap_index];
+    double V22 = table[w.slew_index + 1][w.cap_index + 1];
+
+    return ( V11 * w.c2_minus_c * w.t2_minus_t
+    + V12 * w.c_minus_c1 * w.t2_minus_t
+    + V21 * w.c2_minus_c * w.t_minus_t1
+    + V22 * w.c_minus_c1 * w.t_minus_t1 ) / w.area;
+}
+
+} // namespace
+
+GateTiming interpolate_gate_timing(const GateInfo* gate_info, double input_slew, double load_capacitance) {
+    GateTiming timing;
+    LutWeights delay_weights = make_weights(gate_info->cell_delayindex1, gate_info->cell_delayindex2, input_slew, load_capacitance);
+    timing.delay = interpolate(gate_info->cell_delay, delay_weights);
+
+    if (gate_info->shared_axes) {
+        timing.slew = interpolate(gate_info->output_slew, delay_weights);
+    } else {
+        LutWeights slew_weights = make_weights(gate_info->output_slewindex1, gate_info->output_slewindex2, input_slew, load_capacitance);
+        timing.slew = interpolate(gate_info->output_slew, slew_weights);
+    }
+    return timing;
+}
+
+namespace {
+
+// The four table values around each lane's point and the axis values
+// bracketing it, gathered lane by lane so the arithmetic runs on whole vectors
+struct CornerLutPoints {
+    CornerTiming T1, T2, C1, C2;
+    CornerTiming V11, V12, V21, V22;
+};
+
+inline void gather_lut_point(CornerLutPoints& points, int lane, const double* slew_axis, const double* cap_axis,
+                             const double table[GATE_LUT_DIM][GATE_LUT_DIM], int slew_index, int cap_index) {
+    points.T1[lane] = slew_axis[slew_index];
+    points.T2[lane] = slew_axis[slew_index + 1];
+    points.C1[lane] = cap_axis[cap_index];
+    points.C2[lane] = cap_axis[cap_index + 1];
+    points.V11[lane] = table[slew_index][cap_index];
+    points.V12[lane] = table[slew_index][cap_index + 1];
+    points.V21[lane] = table[slew_index + 1][cap_index];
+    points.V22[lane] = table[slew_index + 1][cap_index + 1];
+}
+
+// Same expression as interpolate() on LutWeights, so every lane rounds
+// exactly like the scalar version. Vectors are passed by reference, as
+// passing them by value changes with the instruction set
+inline void interpolate_corners(const CornerLutPoints& points, const CornerTiming& input_slew, const CornerTiming& load_capacitance,
+                                CornerTiming& value) {
+    CornerTiming c2_minus_c = points.C2 - load_capacitance;
+    CornerTiming c_minus_c1 = load_capacitance - points.C1;
+    CornerTiming t2_minus_t = points.T2 - input_slew;
+    CornerTiming t_minus_t1 = input_slew - points.T1;
+    CornerTiming area = (points.C2 - points.C1) * (points.T2 - points.T1);
+
+    value = ( points.V11 * c2_minus_c * t2_minus_t
+    + points.V12 * c_minus_c1 * t2_minus_t
+    + points.V21 * c2_minus_c * t_minus_t1
+    + points.V22 * c_minus_c1 * t_minus_t1 ) / area;
+}
+
+} // namespace
+
+CornerGateTiming interpolate_corner_timing(const CornerGateInfo& gate_info, int num_corners, const CornerTiming& input_slew, const CornerTiming& load_capacitance) {
+    // a single corner, the default, takes the scalar kernel and skips the
+    // lane gathers; the unused lanes are left at zero
+    if (num_corners == 1) {
+        GateTiming scalar = interpolate_gate_timing(gate_info.corner[0], input_slew[0], load_capacitance[0]);
+        CornerGateTiming timing = {};
+        timing.delay[0] = scalar.delay;
+        timing.slew[0] = scalar.slew;
+        return timing;
+    }
+
+    // unused lanes interpolate a zero table over a unit square
+    CornerTiming zero = {};
+    CornerTiming one = zero + 1;
+    CornerLutPoints delay_points = {zero, one, zero, one, zero, zero, zero, zero};
+    CornerLutPoints slew_points = delay_points;
+
+    for (int lane = 0; lane < num_corners; lane++) {
+        const GateInfo* info = gate_info.corner[lane];
+        int slew_index = find_bracket(info->cell_delayindex1, input_slew[lane]);
+        int cap_index = find_bracket(info->cell_delayindex2, load_capacitance[lane]);
+        gather_lut_point(delay_points, lane, info->cell_delayindex1, info->cell_delayindex2, info->cell_delay,
+                         slew_index, cap_index);
+
+        if (!info->shared_axes) {
+            slew_index = find_bracket(info->output_slewindex1, input_slew[lane]);
+            cap_index = find_bracket(info->output_slewindex2, load_capacitance[lane]);
+        }
+        gather_lut_point(slew_points, lane, info->output_slewindex1, info->output_slewindex2, info->output_slew,
+                         slew_index, cap_index);
+    }
+
+    CornerGateTiming timing;
+    interpolate_corners(delay_points, input_slew, load_capacitance, timing.delay);
+    interpolate_corners(slew_points, input_slew, load_capacitance, timing.slew);
+    return timing;
+}
+
 void GateDatabase::test() {
     for (const auto& key_value: gate_info_lut_) {
         cout << key_value.first << '\t' << key_value.second->cell_delay[GATE_LUT_DIM-1][GATE_LUT_DIM-1] 
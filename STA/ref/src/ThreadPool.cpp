@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int num_threads) :
+        job_(nullptr),
+        job_count_(0),
+        job_chunk_(1),
+        next_index_(0),
+        generation_(0),
+        busy_workers_(0),
+        stopping_(false) {
+    for (unsigned int i = 1; i < num_threads; i++) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::size() const {
+    return workers_.size() + 1;
+}
+
+void ThreadPool::parallel_for(size_t count, size_t min_chunk, const RangeFunction& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    // Not worth waking anyone up for
+    if (workers_.empty() || count <= min_chunk) {
+        fn(0, count);
+        return;
+    }
+
+    // A few chunks per thread so uneven chunks still balance out
+    size_t chunk = std::max(min_chunk, count / (size() * 4) + 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        job_count_ = count;
+        job_chunk_ = chunk;
+        next_index_.store(0, std::memory_order_relaxed);
+        busy_workers_ = workers_.size();
+        generation_++;
+    }
+    work_ready_.notify_all();
+
+    run_chunks();
+
+    // fn lives on our stack, so every worker has to be done with it
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this] { return busy_workers_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::worker_loop() {
+    unsigned long seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        run_chunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_workers_--;
+        }
+        work_done_.notify_one();
+    }
+}
+
+void ThreadPool::run_chunks() {
+    while (true) {
+        size_t begin = next_index_.fetch_add(job_chunk_, std::memory_order_relaxed);
+        if (begin >= job_count_) {
+            return;
+        }
+        (*job_)(begin, std::min(begin + job_chunk_, job_count_));
+    }
+}
@@ -0,0 +1,559 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <unordered_set>
+
+#include "Timing.hpp"
+
+using namespace std;
+
+bool debug = false;
+
+// Smallest number of gates worth handing to another thread within a level
+const size_t PROPAGATION_MIN_CHUNK = 256;
+
+namespace {
+
+// raise every lane of latest to the one in value if that is later. Vectors are passed
+// by reference, as passing them by value changes with the instruction set
+inline void keepLatest(CornerTiming &latest, const CornerTiming &value) {
+    latest = value > latest ? value : latest;
+}
+
+inline bool sameTiming(const CornerTiming &a, const CornerTiming &b) {
+    for (int lane = 0; lane < MAX_CORNERS; lane++) {
+        if (a[lane] != b[lane]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// gate is an output, can't get its capacitance from connected gates.
+// using the INV capacitance * 4
+void findOutputPadLoad(Circuit &circuit, CornerTiming &outputPadLoad) {
+    outputPadLoad = CornerTiming();
+    for (unsigned int corner = 0; corner < circuit.corner_dbs_.size(); corner++) {
+        outputPadLoad[corner] = circuit.corner_dbs_[corner]->get_gate_info("INV")->capacitance * 4;
+    }
+}
+
+// the circuit delay is the latest arrival at an output with nothing connected to it
+void findCircuitDelay(const TimingGraph &graph, CornerTiming &circuitDelay) {
+    circuitDelay = CornerTiming();
+    for (int node : graph.outputs_) {
+        if ((graph.level_[node] > 0) && (graph.num_fanouts(node) == 0)) {
+            keepLatest(circuitDelay, graph.arrival_[node]);
+        }
+    }
+}
+
+// required time and slack from the delay still ahead of the node
+void refreshNodeSlack(TimingGraph &graph, int node, const CornerTiming &requiredTime) {
+    if (graph.required_known_[node]) {
+        graph.required_[node] = requiredTime - graph.downstream_delay_[node];
+        graph.slack_[node] = graph.required_[node] - graph.arrival_[node];
+    } else {
+        graph.required_[node] = CornerTiming();
+        graph.slack_[node] = CornerTiming();
+    }
+}
+
+void moveNodeToLevel(TimingGraph &graph, int node, int newLevel) {
+    if (graph.level_[node] >= 0) {
+        vector <int>& oldLevel = graph.levels_[graph.level_[node]];
+        int slot = graph.level_slot_[node];
+        oldLevel[slot] = oldLevel.back();
+        graph.level_slot_[oldLevel[slot]] = slot;
+        oldLevel.pop_back();
+    }
+
+    if (newLevel >= 0) {
+        if ((int) graph.levels_.size() <= newLevel) {
+            graph.levels_.resize(newLevel + 1);
+        }
+        graph.level_slot_[node] = graph.levels_[newLevel].size();
+        graph.levels_[newLevel].push_back(node);
+    }
+    graph.level_[node] = newLevel;
+
+    while (graph.levels_.size() > 1 && graph.levels_.back().empty()) {
+        graph.levels_.pop_back();
+    }
+}
+
+// A path being grown back from an output in findWorstPaths: a node, and the arc from it toward the output
+struct PathSearchStep {
+    int node;
+    int pin;                // pin of the next node toward the output the arc drives, -1 at the output
+    int next;               // step of that next node, -1 at the output
+    int endpoint;           // the output the path ends at
+    double delayToEndpoint; // delay from the node's output to the end of the path
+};
+
+TimingPath buildTimingPath(Circuit &circuit, const vector <PathSearchStep> &steps, int stepIndex, int corner) {
+    const TimingGraph &graph = circuit.timing_graph_;
+    const PathSearchStep* step = &steps[stepIndex];
+    TimingPath path;
+
+    double arrival = graph.arrival_[step->node][corner];
+    path.nodes.push_back({circuit.nodes_[graph.node_id_[step->node]], 0, arrival, graph.slew_[step->node][corner]});
+
+    while (step->next != -1) {
+        const PathSearchStep* nextStep = &steps[step->next];
+        arrival += graph.pin_delay_[step->pin][corner];
+        path.nodes.push_back({circuit.nodes_[graph.node_id_[nextStep->node]], graph.pin_delay_[step->pin][corner], arrival,
+                              graph.pin_slew_[step->pin][corner]});
+        step = nextStep;
+    }
+
+    path.delay = arrival;
+    path.slack = graph.required_[step->endpoint][corner] - arrival;
+    return path;
+}
+
+} // namespace
+
+void convertDFFs(Circuit &circuit) {
+    for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
+        if (circuit.nodes_[nodeNum] != NULL) {
+            if (circuit.nodes_[nodeNum]->gate_type_ == "DFF") {
+                if (debug)
+                    cout << "Found DFF at node: " << nodeNum << endl;
+
+                NodeID dataInput = circuit.nodes_[nodeNum]->fanin_list_.front();
+                circuit.nodes_[nodeNum]->fanin_list_.clear();
+                circuit.nodes_[nodeNum]->input_pad_ = true;
+                circuit.nodes_[nodeNum]->output_pad_ = false;
+                circuit.nodes_[nodeNum]->gate_type_ = "";
+                circuit.nodes_[dataInput]->output_pad_ = true;
+            }
+        }
+    }
+
+    if (debug)
+        cout << "Finished Converting DFFs to set of inputs and outputs" << endl;
+
+}
+
+void createFanOutLists(Circuit &circuit) {
+    for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
+        if (circuit.nodes_[nodeNum] != NULL) {
+            for (unsigned int inputNodeNum = 0; inputNodeNum < circuit.nodes_[nodeNum]->fanin_list_.size(); inputNodeNum++) {
+                NodeID node = circuit.nodes_[nodeNum]->fanin_list_[inputNodeNum];
+                circuit.nodes_[nodeNum]->inDegree+=1;
+                circuit.nodes_[node]->outDegree+=1;
+                circuit.nodes_[node]->fanout_list.push_back(nodeNum);
+            }
+        }
+    }
+}
+
+void compileTimingGraph(Circuit &circuit) {
+    circuit.timing_graph_.build(circuit.nodes_, circuit.corner_dbs_);
+    circuit.dirty_arrival_.clear();
+    circuit.dirty_required_.clear();
+
+    if (debug) {
+        cout << "Levelized circuit into " << circuit.timing_graph_.levels_.size() << " levels" << endl;
+    }
+}
+
+void runForwardTraversal(Circuit &circuit, ThreadPool &pool) {
+    TimingGraph &graph = circuit.timing_graph_;
+    CornerTiming outputPadLoad;
+    findOutputPadLoad(circuit, outputPadLoad);
+
+    // every gate on a level only reads gates on lower levels, so a level can be split freely across threads
+    for (unsigned int level = 0; level < graph.levels_.size(); level++) {
+        const vector <int>& levelNodes = graph.levels_[level];
+
+        pool.parallel_for(levelNodes.size(), PROPAGATION_MIN_CHUNK, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                findNodeArrival(graph, levelNodes[i], outputPadLoad);
+            }
+        });
+    }
+
+    findCircuitDelay(graph, circuit.totalCircuitDelay);
+
+    circuit.dirty_arrival_.clear();
+
+    if (debug) {
+        cout << "Finished Running Traversals" << endl;
+    }
+}
+
+void findNodeArrival(TimingGraph &graph, int node, const CornerTiming &outputPadLoad) {
+    int faninBegin = graph.fanin_start_[node];
+    int faninEnd = graph.fanin_end_[node];
+    int fanoutBegin = graph.fanout_start_[node];
+    int fanoutEnd = graph.fanout_end_[node];
+
+    // inputs drive their fanouts with a fixed slew at time 0
+    if (graph.input_pad_[node]) {
+        CornerTiming loadCap = {};
+        for (int edge = fanoutBegin; edge < fanoutEnd; edge++) {
+            loadCap += graph.gate_info_[graph.fanout_[edge]].capacitance;
+        }
+        graph.load_[node] = loadCap;
+        graph.slew_[node] = CornerTiming() + 0.002;
+        graph.arrival_[node] = CornerTiming();
+        return;
+    }
+
+    CornerTiming loadCap = {};
+    if ((graph.output_pad_[node]) && (fanoutBegin == fanoutEnd)) {
+        loadCap = outputPadLoad;
+    }
+
+    // gate is not an output, get its capacitance by summing the gates its connected to
+    else {
+        for (int edge = fanoutBegin; edge < fanoutEnd; edge++) {
+            loadCap += graph.gate_info_[graph.fanout_[edge]].capacitance;
+        }
+    }
+
+    unsigned int numInputs = faninEnd - faninBegin;
+    double multiplier = 1;
+
+    if (numInputs > 2) {
+        multiplier = numInputs / 2;
+    }
+
+    const CornerGateInfo& gateInfo = graph.gate_info_[node];
+    CornerTiming timeOut = {};
+    CornerTiming slewOut = {};
+    CornerTiming cellDelay = {};
+
+    for (int pin = faninBegin; pin < faninEnd; pin++) {
+        int driver = graph.fanin_[pin];
+        CornerGateTiming timing = interpolate_corner_timing(gateInfo, graph.num_corners_, graph.slew_[driver], loadCap);
+        CornerTiming outputDelay = multiplier * timing.delay;
+        CornerTiming outputSlew = multiplier * timing.slew;
+        CornerTiming inputTimeOut = graph.arrival_[driver] + outputDelay;
+        graph.pin_delay_[pin] = outputDelay;
+        graph.pin_slew_[pin] = outputSlew;
+
+        // each corner keeps its own latest input
+        auto later = inputTimeOut > timeOut;
+        timeOut = later ? inputTimeOut : timeOut;
+        slewOut = later ? outputSlew : slewOut;
+        cellDelay = later ? outputDelay : cellDelay;
+    }
+
+    graph.load_[node] = loadCap;
+    graph.arrival_[node] = timeOut;
+    graph.slew_[node] = slewOut;
+    graph.cell_delay_[node] = cellDelay;
+}
+
+void findNodeRequiredTime(TimingGraph &graph, int node, const CornerTiming &requiredTime) {
+    int fanoutBegin = graph.fanout_start_[node];
+    int fanoutEnd = graph.fanout_end_[node];
+
+    // a gate's required time is known once all of the gates it drives have theirs.
+    // outputs are always constrained by the circuit required time
+    bool fanoutsKnown = fanoutBegin != fanoutEnd;
+    for (int edge = fanoutBegin; edge < fanoutEnd; edge++) {
+        if (!graph.required_known_[graph.fanout_[edge]]) {
+            fanoutsKnown = false;
+            break;
+        }
+    }
+
+    graph.required_known_[node] = graph.output_pad_[node] || fanoutsKnown;
+
+    // the longest delay from this gate's output to a constrained output. Keeping this
+    // rather than the required time itself means a new circuit delay only shifts every
+    // required time, without walking the graph again
+    CornerTiming downstreamDelay = {};
+
+    if (fanoutsKnown) {
+        for (int edge = fanoutBegin; edge < fanoutEnd; edge++) {
+            // the edge knows which input of the output node it drives
+            CornerTiming tempDownstreamDelay = graph.downstream_delay_[graph.fanout_[edge]] + graph.arc_delay(edge);
+            keepLatest(downstreamDelay, tempDownstreamDelay);
+        }
+    }
+
+    graph.downstream_delay_[node] = downstreamDelay;
+    refreshNodeSlack(graph, node, requiredTime);
+}
+
+void runBackwardTraversal (Circuit &circuit, ThreadPool &pool) {
+    TimingGraph &graph = circuit.timing_graph_;
+
+    CornerTiming requiredTime;
+    requiredTime = 1.1 * circuit.totalCircuitDelay;
+
+    // every gate on a level only reads gates on higher levels, so walk the levels from the outputs back
+    for (int level = graph.levels_.size() - 1; level >= 0; level--) {
+        const vector <int>& levelNodes = graph.levels_[level];
+
+        pool.parallel_for(levelNodes.size(), PROPAGATION_MIN_CHUNK, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                findNodeRequiredTime(graph, levelNodes[i], requiredTime);
+            }
+        });
+    }
+
+    circuit.dirty_required_.clear();
+}
+
+void runIncrementalTraversal(Circuit &circuit) {
+    if (circuit.dirty_arrival_.empty() && circuit.dirty_required_.empty()) {
+        return;
+    }
+
+    typedef pair <int, int> LevelEntry;
+
+    TimingGraph &graph = circuit.timing_graph_;
+    CornerTiming outputPadLoad;
+    findOutputPadLoad(circuit, outputPadLoad);
+    CornerTiming oldRequiredTime = 1.1 * circuit.totalCircuitDelay;
+
+    // nodes whose arrival or required time was recomputed, their slack needs refreshing
+    vector <int> retimedNodes;
+    unordered_set <int> requiredSeeds(circuit.dirty_required_.begin(), circuit.dirty_required_.end());
+
+    // forward: lowest level first, so a gate is evaluated once after all of its changed fanins
+    priority_queue <LevelEntry, vector <LevelEntry>, greater <LevelEntry> > forwardQueue;
+    unordered_set <int> queued;
+
+    for (int node : circuit.dirty_arrival_) {
+        if (graph.level_[node] >= 0 && queued.insert(node).second) {
+            forwardQueue.push(LevelEntry(graph.level_[node], node));
+        }
+    }
+
+    vector <CornerTiming> oldPinDelays;
+    while (!forwardQueue.empty()) {
+        int node = forwardQueue.top().second;
+        forwardQueue.pop();
+
+        CornerTiming oldTimeOut = graph.arrival_[node];
+        CornerTiming oldSlewOut = graph.slew_[node];
+        oldPinDelays.assign(graph.pin_delay_.begin() + graph.fanin_start_[node], graph.pin_delay_.begin() + graph.fanin_end_[node]);
+
+        findNodeArrival(graph, node, outputPadLoad);
+        retimedNodes.push_back(node);
+
+        // the fanouts only see this gate's arrival and slew
+        if (!sameTiming(graph.arrival_[node], oldTimeOut) || !sameTiming(graph.slew_[node], oldSlewOut)) {
+            for (int edge = graph.fanout_start_[node]; edge < graph.fanout_end_[node]; edge++) {
+                int sink = graph.fanout_[edge];
+                if (graph.level_[sink] >= 0 && queued.insert(sink).second) {
+                    forwardQueue.push(LevelEntry(graph.level_[sink], sink));
+                }
+            }
+        }
+
+        // the fanins' required times are taken through this gate's delays
+        if (!equal(oldPinDelays.begin(), oldPinDelays.end(), graph.pin_delay_.begin() + graph.fanin_start_[node], sameTiming)) {
+            requiredSeeds.insert(graph.fanin_.begin() + graph.fanin_start_[node], graph.fanin_.begin() + graph.fanin_end_[node]);
+        }
+    }
+
+    findCircuitDelay(graph, circuit.totalCircuitDelay);
+    CornerTiming requiredTime = 1.1 * circuit.totalCircuitDelay;
+
+    // backward: highest level first, so a gate is evaluated once after all of its changed fanouts
+    priority_queue <LevelEntry> backwardQueue;
+    queued.clear();
+
+    for (int node : requiredSeeds) {
+        if (graph.level_[node] >= 0 && queued.insert(node).second) {
+            backwardQueue.push(LevelEntry(graph.level_[node], node));
+        }
+    }
+
+    while (!backwardQueue.empty()) {
+        int node = backwardQueue.top().second;
+        backwardQueue.pop();
+
+        bool oldRequiredKnown = graph.required_known_[node];
+        CornerTiming oldDownstreamDelay = graph.downstream_delay_[node];
+
+        findNodeRequiredTime(graph, node, requiredTime);
+        retimedNodes.push_back(node);
+
+        if (graph.required_known_[node] != oldRequiredKnown || !sameTiming(graph.downstream_delay_[node], oldDownstreamDelay)) {
+            for (int pin = graph.fanin_start_[node]; pin < graph.fanin_end_[node]; pin++) {
+                int driver = graph.fanin_[pin];
+                if (graph.level_[driver] >= 0 && queued.insert(driver).second) {
+                    backwardQueue.push(LevelEntry(graph.level_[driver], driver));
+                }
+            }
+        }
+    }
+
+    // a new circuit delay moves the required time of every gate, otherwise only the retimed ones changed
+    if (!sameTiming(requiredTime, oldRequiredTime)) {
+        for (const vector <int>& levelNodes : graph.levels_) {
+            for (int node : levelNodes) {
+                refreshNodeSlack(graph, node, requiredTime);
+            }
+        }
+    } else {
+        for (int node : retimedNodes) {
+            refreshNodeSlack(graph, node, requiredTime);
+        }
+    }
+
+    if (debug) {
+        cout << "Incremental update re-timed " << retimedNodes.size() << " nodes" << endl;
+    }
+
+    circuit.dirty_arrival_.clear();
+    circuit.dirty_required_.clear();
+}
+
+void relevelFanoutCone(TimingGraph &graph, int node) {
+    queue <int> nodeQueue;
+    nodeQueue.push(node);
+
+    while (!nodeQueue.empty()) {
+        int operatingNode = nodeQueue.front();
+        nodeQueue.pop();
+
+        int newLevel = 0;
+        if (!graph.input_pad_[operatingNode]) {
+            newLevel = graph.num_fanins(operatingNode) == 0 ? -1 : 1;
+            for (int pin = graph.fanin_start_[operatingNode]; pin < graph.fanin_end_[operatingNode]; pin++) {
+                int faninLevel = graph.level_[graph.fanin_[pin]];
+                if (faninLevel < 0) {
+                    newLevel = -1;
+                    break;
+                }
+                newLevel = max(newLevel, faninLevel + 1);
+            }
+        }
+
+        if (newLevel == graph.level_[operatingNode]) {
+            continue;
+        }
+
+        moveNodeToLevel(graph, operatingNode, newLevel);
+        for (int edge = graph.fanout_start_[operatingNode]; edge < graph.fanout_end_[operatingNode]; edge++) {
+            nodeQueue.push(graph.fanout_[edge]);
+        }
+    }
+}
+
+double findWorstSlack (Circuit &circuit, int corner) {
+    const TimingGraph &graph = circuit.timing_graph_;
+    double worstSlack = numeric_limits<double>::max();
+
+    for (int node : graph.outputs_) {
+        if (graph.level_[node] >= 0 && graph.slack_[node][corner] < worstSlack) {
+            worstSlack = graph.slack_[node][corner];
+        }
+    }
+
+    return worstSlack;
+}
+
+vector <CircuitNode*> findCriticalPath (Circuit &circuit, int corner) {
+    const TimingGraph &graph = circuit.timing_graph_;
+    vector <CircuitNode*> criticalPath;
+    int minSlackNode = -1;
+    double minSlack = numeric_limits<double>::max();
+
+    // find output node with smallest slack
+    for (int node : graph.outputs_) {
+        if (graph.slack_[node][corner] < minSlack) {
+            minSlack = graph.slack_[node][corner];
+            minSlackNode = node;
+        }
+    }
+
+    criticalPath.push_back(circuit.nodes_[graph.node_id_[minSlackNode]]);
+
+    // iterate through remaining nodes in critical path
+    while(1) {
+
+        // found input pad, we are done.
+        if (graph.input_pad_[minSlackNode]) {
+            break;
+        }
+
+        double minSlack = numeric_limits<double>::max(); // set minSlack to maxDouble
+
+        int tempMinSlackNode = -1;
+
+        // find node with smallest slack
+        for (int pin = graph.fanin_start_[minSlackNode]; pin < graph.fanin_end_[minSlackNode]; pin++) {
+            int inputNode = graph.fanin_[pin];
+            if (graph.slack_[inputNode][corner] < minSlack) {
+                tempMinSlackNode = inputNode;
+                minSlack = graph.slack_[inputNode][corner];
+            }
+        }
+
+        criticalPath.push_back(circuit.nodes_[graph.node_id_[tempMinSlackNode]]);
+        minSlackNode = tempMinSlackNode;
+
+    }
+
+    return criticalPath;
+
+}
+
+vector <TimingPath> findWorstPaths (Circuit &circuit, unsigned int maxPaths, double maxSlack, unsigned int maxPathsPerEndpoint, int corner) {
+    const TimingGraph &graph = circuit.timing_graph_;
+    vector <TimingPath> worstPaths;
+    vector <PathSearchStep> steps;
+    vector <unsigned int> endpointPaths(graph.num_nodes(), 0);
+
+    // smallest slack any completion of a step can reach, then the step. The best completion of a
+    // step follows the latest arrival back to an input, so the bound is exact and paths come off
+    // the heap worst first
+    typedef pair <double, int> SearchEntry;
+    priority_queue <SearchEntry, vector <SearchEntry>, greater <SearchEntry>> searchHeap;
+
+    for (int node : graph.outputs_) {
+        if (graph.level_[node] >= 0) {
+            steps.push_back({node, -1, -1, node, 0});
+            searchHeap.push({graph.required_[node][corner] - graph.arrival_[node][corner], steps.size() - 1});
+        }
+    }
+
+    while (!searchHeap.empty() && worstPaths.size() < maxPaths) {
+        double slackBound = searchHeap.top().first;
+        int stepIndex = searchHeap.top().second;
+        searchHeap.pop();
+
+        if (slackBound > maxSlack) {
+            break;
+        }
+
+        PathSearchStep step = steps[stepIndex];
+        if ((maxPathsPerEndpoint != 0) && (endpointPaths[step.endpoint] >= maxPathsPerEndpoint)) {
+            continue;
+        }
+
+        // reached an input, so this is the worst path not yet reported
+        if (graph.input_pad_[step.node]) {
+            endpointPaths[step.endpoint] += 1;
+            worstPaths.push_back(buildTimingPath(circuit, steps, stepIndex, corner));
+            continue;
+        }
+
+        for (int pin = graph.fanin_start_[step.node]; pin < graph.fanin_end_[step.node]; pin++) {
+            int driver = graph.fanin_[pin];
+            if (graph.level_[driver] < 0) {
+                continue;
+            }
+
+            double delayToEndpoint = step.delayToEndpoint + graph.pin_delay_[pin][corner];
+            steps.push_back({driver, pin, stepIndex, step.endpoint, delayToEndpoint});
+            searchHeap.push({graph.required_[step.endpoint][corner] - delayToEndpoint - graph.arrival_[driver][corner], steps.size() - 1});
+        }
+    }
+
+    return worstPaths;
+}
@@ -0,0 +1,254 @@
+#include <queue>
+#include <algorithm>
+
+#include "TimingGraph.hpp"
+
+using namespace std;
+
+void TimingGraph::build(const std::vector<CircuitNode*>& nodes, const std::vector<GateDatabase*>& corner_dbs) {
+    // Levelize on the ISCAS IDs first: a gate sits one level above its deepest
+    // fanin, and is placed once all of its fanins are
+    vector<int> node_level(nodes.size(), -1);
+    vector<int> pending_fanins(nodes.size(), 0);
+    vector<vector<NodeID>> level_nodes(1);
+    queue<NodeID> node_queue;
+
+    for (NodeID node_id = 0; node_id < (NodeID) nodes.size(); node_id++) {
+        if (nodes[node_id] == nullptr)
+            continue;
+
+        pending_fanins[node_id] = nodes[node_id]->fanin_list_.size();
+        if (nodes[node_id]->input_pad_) {
+            node_level[node_id] = 0;
+            level_nodes[0].push_back(node_id);
+            node_queue.push(node_id);
+        }
+    }
+
+    while (!node_queue.empty()) {
+        NodeID node_id = node_queue.front();
+        node_queue.pop();
+
+        for (NodeID fanout_id : nodes[node_id]->fanout_list) {
+            node_level[fanout_id] = max(node_level[fanout_id], node_level[node_id] + 1);
+            pending_fanins[fanout_id] -= 1;
+
+            if (pending_fanins[fanout_id] == 0) {
+                if ((int) level_nodes.size() <= node_level[fanout_id])
+                    level_nodes.resize(node_level[fanout_id] + 1);
+                level_nodes[node_level[fanout_id]].push_back(fanout_id);
+                node_queue.push(fanout_id);
+            }
+        }
+    }
+
+    // Dense order is level by level, with the unreached gates at the end
+    node_id_.clear();
+    index_of_.assign(nodes.size(), -1);
+    levels_.assign(level_nodes.size(), vector<int>());
+    level_slot_.assign(nodes.size(), -1);
+
+    for (unsigned int level = 0; level < level_nodes.size(); level++) {
+        for (NodeID node_id : level_nodes[level]) {
+            index_of_[node_id] = node_id_.size();
+            level_slot_[node_id_.size()] = levels_[level].size();
+            levels_[level].push_back(node_id_.size());
+            node_id_.push_back(node_id);
+        }
+    }
+    for (NodeID node_id = 0; node_id < (NodeID) nodes.size(); node_id++) {
+        if (nodes[node_id] != nullptr && index_of_[node_id] == -1) {
+            index_of_[node_id] = node_id_.size();
+            node_id_.push_back(node_id);
+        }
+    }
+
+    int num_nodes = node_id_.size();
+    num_corners_ = corner_dbs.size();
+    gate_info_.resize(num_nodes);
+    input_pad_.resize(num_nodes);
+    output_pad_.resize(num_nodes);
+    level_.resize(num_nodes);
+    level_slot_.resize(num_nodes);
+    fanin_start_.clear();
+    fanin_end_.clear();
+    fanout_start_.clear();
+    fanout_end_.clear();
+    fanin_.clear();
+    fanout_.clear();
+    outputs_.clear();
+
+    for (int node = 0; node < num_nodes; node++) {
+        const CircuitNode* circuit_node = nodes[node_id_[node]];
+        gate_info_[node] = CornerGateInfo();
+        if (circuit_node->gate_info_ != nullptr) {
+            for (int corner = 0; corner < num_corners_; corner++) {
+                const GateInfo* gate_info = corner == 0 ? circuit_node->gate_info_ : corner_dbs[corner]->get_gate_info(circuit_node->gate_type_);
+                gate_info_[node].corner[corner] = gate_info;
+                gate_info_[node].capacitance[corner] = gate_info->capacitance;
+            }
+        }
+        input_pad_[node] = circuit_node->input_pad_;
+        output_pad_[node] = circuit_node->output_pad_;
+        level_[node] = pending_fanins[node_id_[node]] == 0 ? node_level[node_id_[node]] : -1;
+
+        fanin_start_.push_back(fanin_.size());
+        for (NodeID fanin_id : circuit_node->fanin_list_)
+            fanin_.push_back(index_of_[fanin_id]);
+        fanin_end_.push_back(fanin_.size());
+
+        fanout_start_.push_back(fanout_.size());
+        for (NodeID fanout_id : circuit_node->fanout_list)
+            fanout_.push_back(index_of_[fanout_id]);
+        fanout_end_.push_back(fanout_.size());
+    }
+
+    fanin_limit_ = fanin_end_;
+    fanout_limit_ = fanout_end_;
+
+    for (NodeID node_id = 0; node_id < (NodeID) nodes.size(); node_id++) {
+        if (nodes[node_id] != nullptr && nodes[node_id]->output_pad_)
+            outputs_.push_back(index_of_[node_id]);
+    }
+
+    // Pair every fanout edge with a pin of its sink. A gate can take the same
+    // driver on several pins, so each edge claims the first pin not taken yet
+    fanout_pin_.assign(fanout_.size(), -1);
+    vector<char> pin_claimed(fanin_.size(), 0);
+    for (int node = 0; node < num_nodes; node++) {
+        for (int edge = fanout_start_[node]; edge < fanout_end_[node]; edge++) {
+            int sink = fanout_[edge];
+            for (int pin = fanin_start_[sink]; pin < fanin_end_[sink]; pin++) {
+                if (fanin_[pin] == node && !pin_claimed[pin]) {
+                    pin_claimed[pin] = 1;
+                    fanout_pin_[edge] = pin - fanin_start_[sink];
+                    break;
+                }
+            }
+        }
+    }
+
+    CornerTiming zero = {};
+    load_.assign(num_nodes, zero);
+    arrival_.assign(num_nodes, zero);
+    slew_.assign(num_nodes, zero);
+    cell_delay_.assign(num_nodes, zero);
+    downstream_delay_.assign(num_nodes, zero);
+    required_.assign(num_nodes, zero);
+    slack_.assign(num_nodes, zero);
+    required_known_.assign(num_nodes, 0);
+    pin_delay_.assign(fanin_.size(), zero);
+    pin_slew_.assign(fanin_.size(), zero);
+}
+
+int TimingGraph::num_nodes() const {
+    return node_id_.size();
+}
+
+int TimingGraph::num_fanins(int node) const {
+    return fanin_end_[node] - fanin_start_[node];
+}
+
+int TimingGraph::num_fanouts(int node) const {
+    return fanout_end_[node] - fanout_start_[node];
+}
+
+int TimingGraph::sink_pin(int edge) const {
+    return fanin_start_[fanout_[edge]] + fanout_pin_[edge];
+}
+
+const CornerTiming& TimingGraph::arc_delay(int edge) const {
+    return pin_delay_[sink_pin(edge)];
+}
+
+int TimingGraph::find_edge(int driver, int sink) const {
+    for (int edge = fanout_start_[driver]; edge < fanout_end_[driver]; edge++) {
+        if (fanout_[edge] == sink)
+            return edge;
+    }
+    return -1;
+}
+
+int TimingGraph::latest_edge(int driver, int sink, int corner) const {
+    int latest = -1;
+    for (int edge = fanout_start_[driver]; edge < fanout_end_[driver]; edge++) {
+        if (fanout_[edge] == sink && (latest == -1 || arc_delay(edge)[corner] > arc_delay(latest)[corner]))
+            latest = edge;
+    }
+    return latest;
+}
+
+void TimingGraph::add_edge(int driver, int sink) {
+    if (fanin_end_[sink] == fanin_limit_[sink])
+        grow_fanin_row(sink);
+    int pin = fanin_end_[sink]++;
+    fanin_[pin] = driver;
+    pin_delay_[pin] = CornerTiming();
+    pin_slew_[pin] = CornerTiming();
+
+    if (fanout_end_[driver] == fanout_limit_[driver])
+        grow_fanout_row(driver);
+    int edge = fanout_end_[driver]++;
+    fanout_[edge] = sink;
+    fanout_pin_[edge] = pin - fanin_start_[sink];
+}
+
+void TimingGraph::remove_edge(int driver, int sink) {
+    int pin = find(fanin_.begin() + fanin_start_[sink], fanin_.begin() + fanin_end_[sink], driver) - fanin_.begin();
+    int removed_pin = pin - fanin_start_[sink];
+
+    // Drop the edge feeding that pin, then renumber the edges feeding the
+    // sink's later pins, which all move down by one
+    int removed_edge = fanout_start_[driver];
+    while (fanout_[removed_edge] != sink || fanout_pin_[removed_edge] != removed_pin)
+        removed_edge++;
+    copy(fanout_.begin() + removed_edge + 1, fanout_.begin() + fanout_end_[driver], fanout_.begin() + removed_edge);
+    copy(fanout_pin_.begin() + removed_edge + 1, fanout_pin_.begin() + fanout_end_[driver], fanout_pin_.begin() + removed_edge);
+    fanout_end_[driver] -= 1;
+
+    for (int later_pin = removed_pin + 1; later_pin < num_fanins(sink); later_pin++) {
+        int later_driver = fanin_[fanin_start_[sink] + later_pin];
+        for (int edge = fanout_start_[later_driver]; edge < fanout_end_[later_driver]; edge++) {
+            if (fanout_[edge] == sink && fanout_pin_[edge] == later_pin) {
+                fanout_pin_[edge] = later_pin - 1;
+                break;
+            }
+        }
+    }
+
+    copy(fanin_.begin() + pin + 1, fanin_.begin() + fanin_end_[sink], fanin_.begin() + pin);
+    copy(pin_delay_.begin() + pin + 1, pin_delay_.begin() + fanin_end_[sink], pin_delay_.begin() + pin);
+    copy(pin_slew_.begin() + pin + 1, pin_slew_.begin() + fanin_end_[sink], pin_slew_.begin() + pin);
+    fanin_end_[sink] -= 1;
+}
+
+void TimingGraph::grow_fanin_row(int node) {
+    int count = num_fanins(node);
+    int start = fanin_.size();
+    int room = max(2 * count, 2);
+    fanin_.resize(start + room, -1);
+    pin_delay_.resize(start + room, CornerTiming());
+    pin_slew_.resize(start + room, CornerTiming());
+
+    // The pin timing moves along, the incremental update compares against it
+    copy(fanin_.begin() + fanin_start_[node], fanin_.begin() + fanin_end_[node], fanin_.begin() + start);
+    copy(pin_delay_.begin() + fanin_start_[node], pin_delay_.begin() + fanin_end_[node], pin_delay_.begin() + start);
+    copy(pin_slew_.begin() + fanin_start_[node], pin_slew_.begin() + fanin_end_[node], pin_slew_.begin() + start);
+    fanin_start_[node] = start;
+    fanin_end_[node] = start + count;
+    fanin_limit_[node] = start + room;
+}
+
+void TimingGraph::grow_fanout_row(int node) {
+    int count = num_fanouts(node);
+    int start = fanout_.size();
+    int room = max(2 * count, 2);
+    fanout_.resize(start + room, -1);
+    fanout_pin_.resize(start + room, -1);
+
+    copy(fanout_.begin() + fanout_start_[node], fanout_.begin() + fanout_end_[node], fanout_.begin() + start);
+    copy(fanout_pin_.begin() + fanout_start_[node], fanout_pin_.begin() + fanout_end_[node], fanout_pin_.begin() + start);
+    fanout_start_[node] = start;
+    fanout_end_[node] = start + count;
+    fanout_limit_[node] = start + room;
+}
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include "Circuit.hpp"
+#include "ThreadPool.hpp"
+#include "Timing.hpp"
+
+using namespace std;
+
+// Checks the incremental timing API against full analysis. The same random
+// what-if edits (gate type changes, added and removed fanouts) are applied to
+// two copies of a circuit; after every edit one copy is brought up to date by
+// update_timing() and the other is compiled and traversed from scratch, and
+// every timing value and the critical path must come out identical
+
+/**
+ * Compile the circuit and run a full forward and backward traversal on it
+ * @param circuit the circuit to analyze
+ * @param pool the threads each level is split across
+ */
+void analyzeFully (Circuit &circuit, ThreadPool &pool);
+/**
+ * Compare every per-node timing value of two analyzed copies of a circuit, matching nodes by ISCAS node ID
+ * @param incremental the copy updated incrementally
+ * @param full the copy analyzed from scratch
+ * @param edit number of the edit just applied, for the report
+ * @return returns the number of values that differ
+ */
+int compareTiming (Circuit &incremental, Circuit &full, int edit);
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        cout << "Error: Not Enough Arguments, Requires 2 Arguments, <library_file> <circuit_file> [-edits <count>] [-seed <seed>] [-corner <library_file>]..." << endl;
+        return -1;
+    }
+
+    vector <string> libraryFiles(1, argv[1]);
+    int numEdits = 200;
+    unsigned int seed = 1;
+
+    for (int argNum = 3; argNum < argc; argNum++) {
+        string arg = argv[argNum];
+
+        if (arg == "-edits" && argNum + 1 < argc) {
+            numEdits = atoi(argv[++argNum]);
+        } else if (arg == "-seed" && argNum + 1 < argc) {
+            seed = atoi(argv[++argNum]);
+        } else if (arg == "-corner" && argNum + 1 < argc) {
+            if (libraryFiles.size() == MAX_CORNERS) {
+                cout << "Error: At most " << MAX_CORNERS << " corners are supported" << endl;
+                return -1;
+            }
+            libraryFiles.push_back(argv[++argNum]);
+        } else {
+            cout << "Error: Unknown Argument " << arg << endl;
+            return -1;
+        }
+    }
+
+    Circuit incremental (argv[2], libraryFiles);
+    Circuit full (argv[2], libraryFiles);
+    ThreadPool pool(1);
+
+    for (Circuit *circuit : {&incremental, &full}) {
+        convertDFFs(*circuit);
+        createFanOutLists(*circuit);
+        analyzeFully(*circuit, pool);
+    }
+
+    vector <NodeID> gates;
+    for (CircuitNode *node : incremental.nodes_) {
+        if (node != nullptr && !node->is_input_pad()) {
+            gates.push_back(node->node_id_);
+        }
+    }
+    if (gates.empty()) {
+        cout << "Error: The circuit has no gates to edit" << endl;
+        return -1;
+    }
+
+    const vector <string> gateTypes = {"NAND", "NOR", "AND", "OR", "XOR", "INV", "BUF"};
+    mt19937 rng(seed);
+    int applied = 0;
+    int mismatches = 0;
+    double incrementalSeconds = 0.0;
+    double fullSeconds = 0.0;
+
+    for (int edit = 0; edit < numEdits; edit++) {
+        NodeID gate = gates[rng() % gates.size()];
+        const vector <NodeID> &fanins = incremental.nodes_[gate]->fanin_list_;
+        int kind = rng() % 3;
+        bool ok;
+
+        // Edits rejected as invalid must leave both copies untouched as well
+        if (kind == 0 || fanins.size() < 2) {
+            string gateType = gateTypes[rng() % gateTypes.size()];
+            if (fanins.size() == 1) {
+                gateType = rng() % 2 ? "INV" : "BUF";
+            }
+            ok = incremental.change_gate_type(gate, gateType);
+            full.change_gate_type(gate, gateType);
+        } else if (kind == 1) {
+            NodeID driver = fanins[rng() % fanins.size()];
+            ok = incremental.remove_fanout(driver, gate);
+            full.remove_fanout(driver, gate);
+        } else {
+            NodeID driver = gates[rng() % gates.size()];
+            ok = incremental.add_fanout(driver, gate);
+            full.add_fanout(driver, gate);
+        }
+        applied += ok;
+
+        auto start = chrono::steady_clock::now();
+        incremental.update_timing();
+        auto middle = chrono::steady_clock::now();
+        analyzeFully(full, pool);
+        auto end = chrono::steady_clock::now();
+        incrementalSeconds += chrono::duration<double>(middle - start).count();
+        fullSeconds += chrono::duration<double>(end - middle).count();
+
+        mismatches += compareTiming(incremental, full, edit);
+        for (unsigned int corner = 0; corner < incremental.corner_dbs_.size(); corner++) {
+            vector <CircuitNode*> incrementalPath = findCriticalPath(incremental, corner);
+            vector <CircuitNode*> fullPath = findCriticalPath(full, corner);
+            bool samePath = incrementalPath.size() == fullPath.size();
+            for (unsigned int i = 0; samePath && i < incrementalPath.size(); i++) {
+                samePath = incrementalPath[i]->node_id_ == fullPath[i]->node_id_;
+            }
+            if (!samePath) {
+                cout << "Edit " << edit << ": critical path differs in corner " << corner << endl;
+                mismatches++;
+            }
+        }
+    }
+
+    cout << numEdits << " edits (" << applied << " applied), " << mismatches << " mismatches" << endl;
+    cout << "Incremental update: " << incrementalSeconds * 1000 << " ms, full analysis: " << fullSeconds * 1000 << " ms" << endl;
+
+    return mismatches == 0 ? 0 : 1;
+
+}
+
+void analyzeFully (Circuit &circuit, ThreadPool &pool) {
+    compileTimingGraph(circuit);
+    runForwardTraversal(circuit, pool);
+    runBackwardTraversal(circuit, pool);
+}
+
+int compareTiming (Circuit &incremental, Circuit &full, int edit) {
+    const TimingGraph &a = incremental.timing_graph_;
+    const TimingGraph &b = full.timing_graph_;
+    int mismatches = 0;
+
+    for (int corner = 0; corner < a.num_corners_; corner++) {
+        if (incremental.totalCircuitDelay[corner] != full.totalCircuitDelay[corner]) {
+            cout << "Edit " << edit << ": circuit delay differs in corner " << corner << endl;
+            mismatches++;
+        }
+    }
+
+    for (unsigned int nodeId = 0; nodeId < incremental.nodes_.size(); nodeId++) {
+        if (incremental.nodes_[nodeId] == nullptr) {
+            continue;
+        }
+        int x = a.index_of_[nodeId];
+        int y = b.index_of_[nodeId];
+
+        bool same = a.level_[x] == b.level_[y] && a.required_known_[x] == b.required_known_[y];
+        for (int corner = 0; same && corner < a.num_corners_; corner++) {
+            same = a.load_[x][corner] == b.load_[y][corner] &&
+                   a.arrival_[x][corner] == b.arrival_[y][corner] &&
+                   a.slew_[x][corner] == b.slew_[y][corner] &&
+                   a.required_[x][corner] == b.required_[y][corner] &&
+                   a.slack_[x][corner] == b.slack_[y][corner];
+        }
+        if (!same) {
+            if (mismatches < 5) {
+                cout << "Edit " << edit << ": timing of node " << nodeId << " differs" << endl;
+            }
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
@@ -2,12 +2,14 @@
 #define INSTRUMENTATION_HPP
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <atomic>
 #include <mutex>
 #include <chrono>
 #include <iomanip>
 #include <iostream> // Required for std::cerr in macros
+#include <cstdint>
 #include <type_traits> // Required for std::is_arithmetic_v
 
 namespace Instrumentation {
@@ -27,6 +29,10 @@ namespace Instrumentation {
     void enable_file_logging(bool enable);
     void set_log_file(const std::string& file_path);
 
+    // Messages are written out by a background thread. Blocks until everything
+    // the calling thread logged so far has been written
+    void flush();
+
     // Query functions
     size_t get_error_count();
     size_t get_warning_count();
@@ -34,36 +40,208 @@ namespace Instrumentation {
     // Internal logging function (implementation in .cpp)
     void log_message(Severity severity, const std::string& id, const std::string& message);
 
-    // Helper template function using fold expression for variadic arguments
-    template<typename... Args>
-    std::string format_log_message_internal(const Args&... args) {
-        std::ostringstream oss;
-        // Use fold expression to stream arguments separated by spaces
-        ((oss << args << ' '), ...);
-        std::string result = oss.str();
-        // Remove the trailing space if it exists
-        if (!result.empty()) {
-            result.pop_back();
+    namespace detail {
+
+        // Type tag in front of every argument stored in a record
+        enum class ArgType : uint8_t {
+            SIGNED,
+            UNSIGNED,
+            FLOATING,
+            CHARACTER,
+            STRING
+        };
+
+        // Builds one binary log record (timestamp, severity, id, tagged
+        // arguments) in a per-thread scratch buffer. Nothing is formatted
+        // here, the background writer turns records into text
+        class RecordEncoder {
+            public:
+                void begin(Severity severity, std::string_view id);
+                // Hands the record to this thread's ring buffer
+                void commit();
+
+                void put_signed(long long value) { put_tag(ArgType::SIGNED); put_raw(value); }
+                void put_unsigned(unsigned long long value) { put_tag(ArgType::UNSIGNED); put_raw(value); }
+                void put_floating(double value) { put_tag(ArgType::FLOATING); put_raw(value); }
+                void put_character(char value) { put_tag(ArgType::CHARACTER); put_raw(value); }
+                void put_string(std::string_view value) {
+                    put_tag(ArgType::STRING);
+                    put_raw(static_cast<uint32_t>(value.size()));
+                    record_.append(value.data(), value.size());
+                }
+
+            private:
+                void put_tag(ArgType type) { record_.push_back(static_cast<char>(type)); }
+
+                template<typename T>
+                void put_raw(const T& value) { record_.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+                std::string record_;
+                Severity severity_ = Severity::INFO;
+        };
+
+        RecordEncoder& thread_encoder();
+
+        // Stores an argument so the writer prints it exactly as `std::ostream << arg`
+        // would. Types without a binary form are streamed to text right here
+        template<typename T>
+        void encode_arg(RecordEncoder& encoder, const T& arg) {
+            if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+                encoder.put_character(static_cast<char>(arg));
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                encoder.put_signed(arg);
+            } else if constexpr (std::is_integral_v<T>) {
+                // bool included, which streams as 0 or 1
+                encoder.put_unsigned(arg);
+            } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+                encoder.put_floating(arg);
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                encoder.put_string(arg);
+            } else {
+                std::ostringstream oss;
+                oss << arg;
+                encoder.put_string(oss.str());
+            }
         }
-        return result;
+
+    } // namespace detail
+
+    // Encodes one message and queues it for the background writer. The
+    // arguments are written separated by spaces
+    template<typename... Args>
+    void log_record(Severity severity, std::string_view id, const Args&... args) {
+        detail::RecordEncoder& encoder = detail::thread_encoder();
+        encoder.begin(severity, id);
+        (detail::encode_arg(encoder, args), ...);
+        encoder.commit();
     }
 
     // Base macro for logging
     #define INST_MSG(severity, id, ...) \
         do { \
             if (severity >= Instrumentation::get_max_severity()) { \
-                std::string formatted_message = Instrumentation::format_log_message_internal(__VA_ARGS__); \
-                Instrumentation::log_message(severity, id, formatted_message); \
+                Instrumentation::log_record(severity, id, __VA_ARGS__); \
             } \
         } while (0)
 
+    // True if messages of this severity get logged. Call sites that build a
+    // message themselves check it first, so nothing is formatted otherwise
+    inline bool is_logged(Severity severity) { return severity >= get_max_severity(); }
+
     // User-facing macros
     #define INST_INFO(id, ...)    INST_MSG(Instrumentation::Severity::INFO, id, __VA_ARGS__)
     #define INST_WARNING(id, ...) INST_MSG(Instrumentation::Severity::WARNING, id, __VA_ARGS__)
     #define INST_ERROR(id, ...)   INST_MSG(Instrumentation::Severity::ERROR, id, __VA_ARGS__)
     #define INST_FATAL(id, ...)   INST_MSG(Instrumentation::Severity::FATAL, id, __VA_ARGS__)
     #define INST_TRACE(id, ...)   INST_MSG(Instrumentation::Severity::TRACE, id, __VA_ARGS__)
+    #define INST_TRACE_ENABLED()  Instrumentation::is_logged(Instrumentation::Severity::TRACE)
+
+    // --- Metrics ---
+    // Named scope timers, counters and histograms. Every name is registered
+    // once, the first time a call site runs, after which updates are relaxed
+    // atomic operations. Defining INST_DISABLE_METRICS compiles the macros
+    // below out entirely
+
+    enum class MetricsFormat {
+        TABLE,
+        JSON
+    };
+
+    // Asks for a summary of every metric when the program exits, written to
+    // file_path, or to stderr if it is empty. Nothing is written otherwise
+    void set_metrics_report(MetricsFormat format, const std::string& file_path);
+    void write_metrics_report(std::ostream& out, MetricsFormat format);
+
+    class Counter {
+        public:
+            void add(uint64_t amount) { value_.fetch_add(amount, std::memory_order_relaxed); }
+            uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64_t> value_ {0};
+    };
+
+    // Count, sum and range of the recorded values, plus a power of two
+    // histogram: bucket b counts the values that are b bits wide
+    class Histogram {
+        public:
+            static const int NUM_BUCKETS = 65;
+
+            void record(uint64_t value) {
+                count_.fetch_add(1, std::memory_order_relaxed);
+                sum_.fetch_add(value, std::memory_order_relaxed);
+                buckets_[value == 0 ? 0 : 64 - __builtin_clzll(value)].fetch_add(1, std::memory_order_relaxed);
+
+                uint64_t seen = min_.load(std::memory_order_relaxed);
+                while (value < seen && !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+                }
+                seen = max_.load(std::memory_order_relaxed);
+                while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+                }
+            }
+
+            uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+            uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+            uint64_t min() const { return count() == 0 ? 0 : min_.load(std::memory_order_relaxed); }
+            uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+            uint64_t bucket(int bits) const { return buckets_[bits].load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64_t> count_ {0};
+            std::atomic<uint64_t> sum_ {0};
+            std::atomic<uint64_t> min_ {UINT64_MAX};
+            std::atomic<uint64_t> max_ {0};
+            std::atomic<uint64_t> buckets_[NUM_BUCKETS] = {};
+    };
+
+    // Metrics by name, created on first use and alive until exit. A timer is a
+    // histogram of durations in nanoseconds
+    Counter& get_counter(std::string_view name);
+    Histogram& get_histogram(std::string_view name);
+    Histogram& get_timer(std::string_view name);
+
+    // Adds the time between its construction and destruction to a timer
+    class ScopeTimer {
+        public:
+            explicit ScopeTimer(Histogram& timer) : timer_(timer), start_(std::chrono::steady_clock::now()) {}
+            ~ScopeTimer() {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                timer_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+
+            ScopeTimer(const ScopeTimer&) = delete;
+            ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+        private:
+            Histogram& timer_;
+            std::chrono::steady_clock::time_point start_;
+    };
+
+    #define INST_CONCAT_IMPL(a, b) a##b
+    #define INST_CONCAT(a, b) INST_CONCAT_IMPL(a, b)
+
+    #ifndef INST_DISABLE_METRICS
+        // Times the rest of the enclosing block
+        #define INST_SCOPE(name) \
+            static Instrumentation::Histogram& INST_CONCAT(inst_scope_timer_, __LINE__) = Instrumentation::get_timer(name); \
+            Instrumentation::ScopeTimer INST_CONCAT(inst_scope_, __LINE__)(INST_CONCAT(inst_scope_timer_, __LINE__))
+        #define INST_COUNT(name, amount) \
+            do { \
+                static Instrumentation::Counter& inst_counter = Instrumentation::get_counter(name); \
+                inst_counter.add(amount); \
+            } while (0)
+        #define INST_HISTOGRAM(name, value) \
+            do { \
+                static Instrumentation::Histogram& inst_histogram = Instrumentation::get_histogram(name); \
+                inst_histogram.record(value); \
+            } while (0)
+    #else
+        // Arguments are not evaluated
+        #define INST_SCOPE(name) static_cast<void>(0)
+        #define INST_COUNT(name, amount) do { } while (0)
+        #define INST_HISTOGRAM(name, value) do { } while (0)
+    #endif
 
 } // namespace Instrumentation
 
-#endif // INSTRUMENTATION_HPP 
\ No newline at end of file
+#endif // INSTRUMENTATION_HPP
@@ -6,6 +6,7 @@
 #include <cstdlib>
 
 #include "Circuit.hpp"
+#include "instrumentation.hpp"
 
 #define NODE_BUF_SIZE 1000
 
@@ -14,6 +15,7 @@ using namespace std;
 Circuit::Circuit(const std::string& ckt_file, const std::string& lib_file):
         // Call the constructor of GateDatabase
         gate_db_(lib_file) {
+    INST_SCOPE("PARSE_CIRCUIT");
     
     // cout << "Parsing circuit file: " << ckt_file << endl;
     ifstream ifs(ckt_file.c_str());
@@ -4,10 +4,12 @@
 #include <regex>
 
 #include "GateDatabase.hpp"
+#include "instrumentation.hpp"
 
 using namespace std;
 
 GateDatabase::GateDatabase(const std::string& file_name) {
+    INST_SCOPE("PARSE_LIBRARY");
     // cout << "Parsing database file: " << file_name << endl;
 
     // Open file. Check if opened correctly
@@ -8,6 +8,15 @@
 #include <iomanip>
 #include <cstdlib> // For std::exit
 #include <fstream> // For file logging
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <charconv>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
 
 namespace Instrumentation {
 
@@ -15,13 +24,551 @@ namespace Instrumentation {
     std::atomic<size_t> g_error_count {0};
     std::atomic<size_t> g_warning_count {0};
     Severity g_max_severity = Severity::INFO; // Default back to INFO
-    std::mutex g_log_mutex;
+    std::mutex g_log_mutex; // Guards the destination below, taken once per written batch
     bool g_file_logging_enabled = false;
     std::string g_log_file_path = "";
     std::ofstream g_log_file_stream;
 
-    // --- File Logging Control --- 
+    namespace {
+
+        // Ring size per logging thread. A record bigger than half of it skips the ring
+        const size_t RING_CAPACITY = size_t(1) << 22;
+        const size_t RECORD_ALIGN = 8;
+        // Length word telling the reader the rest of the ring is unused and to wrap
+        const uint32_t WRAP_MARKER = 0xFFFFFFFF;
+        // How long the writer sleeps when every ring is empty
+        const std::chrono::milliseconds WRITER_IDLE_WAIT(2);
+
+        size_t align_record(size_t size) {
+            return (size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+        }
+
+        const char* severity_name(Severity severity) {
+            switch (severity) {
+                case Severity::TRACE:   return "TRACE";
+                case Severity::INFO:    return "INFO";
+                case Severity::WARNING: return "WARNING";
+                case Severity::ERROR:   return "ERROR";
+                case Severity::FATAL:   return "FATAL";
+            }
+            return "";
+        }
+
+        // Fixed fields at the start of every record, followed by the id and the arguments
+        struct RecordHeader {
+            int64_t timestamp_ns; // system clock since the epoch, printed to the millisecond
+            uint16_t id_length;
+            uint8_t severity;
+        };
+
+        // Turns records into log lines. Only used by one thread at a time
+        class RecordFormatter {
+            public:
+                // Appends the "<date> <time>.<ms> [SEVERITY] [id] " prefix
+                void append_prefix(std::string& out, const RecordHeader& header, std::string_view id) {
+                    int64_t milliseconds = header.timestamp_ns / 1000000;
+                    int64_t seconds = milliseconds / 1000;
+                    if (seconds != cached_second_ || cached_date_.empty()) {
+                        std::time_t now_c = static_cast<std::time_t>(seconds);
+                        std::tm local_time;
+                        localtime_r(&now_c, &local_time);
+                        char date[32];
+                        std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local_time);
+                        cached_date_ = date;
+                        cached_second_ = seconds;
+                    }
+
+                    char ms[8];
+                    std::snprintf(ms, sizeof(ms), ".%03d", static_cast<int>(milliseconds % 1000));
+                    out += cached_date_;
+                    out += ms;
+                    out += " [";
+                    out += severity_name(static_cast<Severity>(header.severity));
+                    out += "] [";
+                    out.append(id.data(), id.size());
+                    out += "] ";
+                }
+
+                // Appends the whole line for one record, newline included
+                void append_line(std::string& out, const char* record, size_t size) {
+                    RecordHeader header;
+                    std::memcpy(&header, record, sizeof(header));
+                    const char* pos = record + sizeof(header);
+                    const char* end = record + size;
+                    std::string_view id(pos, header.id_length);
+                    pos += header.id_length;
+
+                    append_prefix(out, header, id);
+
+                    bool first = true;
+                    while (pos < end) {
+                        if (!first) {
+                            out += ' ';
+                        }
+                        first = false;
+                        pos = append_arg(out, pos);
+                    }
+                    out += '\n';
+                }
+
+            private:
+                const char* append_arg(std::string& out, const char* pos) {
+                    detail::ArgType type = static_cast<detail::ArgType>(*pos++);
+                    char text[32];
+
+                    switch (type) {
+                        case detail::ArgType::SIGNED: {
+                            long long value;
+                            std::memcpy(&value, pos, sizeof(value));
+                            out.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+                            return pos + sizeof(value);
+                        }
+                        case detail::ArgType::UNSIGNED: {
+                            unsigned long long value;
+                            std::memcpy(&value, pos, sizeof(value));
+                            out.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+                            return pos + sizeof(value);
+                        }
+                        case detail::ArgType::FLOATING: {
+                            // the default ostream format is %g with precision 6
+                            double value;
+                            std::memcpy(&value, pos, sizeof(value));
+                            int length = std::snprintf(text, sizeof(text), "%g", value);
+                            out.append(text, length);
+                            return pos + sizeof(value);
+                        }
+                        case detail::ArgType::CHARACTER:
+                            out += *pos;
+                            return pos + 1;
+                        case detail::ArgType::STRING: {
+                            uint32_t length;
+                            std::memcpy(&length, pos, sizeof(length));
+                            pos += sizeof(length);
+                            out.append(pos, length);
+                            return pos + length;
+                        }
+                    }
+                    return pos;
+                }
+
+                int64_t cached_second_ = 0;
+                std::string cached_date_;
+        };
+
+        void write_to_destination(const std::string& text) {
+            std::lock_guard<std::mutex> lock(g_log_mutex);
+            if (g_file_logging_enabled && g_log_file_stream.is_open()) {
+                g_log_file_stream.write(text.data(), text.size());
+                g_log_file_stream.flush();
+            } else {
+                // Fallback to stderr if file logging is disabled or file not open
+                std::cerr.write(text.data(), text.size());
+            }
+        }
+
+        // Lock-free single producer, single consumer ring of one thread's records.
+        // Each record is a length word and the record, padded to RECORD_ALIGN.
+        // Positions count every byte ever written or read, so they never wrap
+        class ThreadLogBuffer {
+            public:
+                ThreadLogBuffer() : next_(nullptr), data_(new char[RING_CAPACITY]), write_pos_(0), read_pos_(0) {}
+
+                // Producer side. Waits for the writer thread if the ring is full
+                template<typename WakeWriter>
+                void push(const char* record, uint32_t size, WakeWriter wake_writer) {
+                    size_t needed = align_record(sizeof(uint32_t) + size);
+                    size_t write = write_pos_.load(std::memory_order_relaxed);
+                    size_t offset = write & (RING_CAPACITY - 1);
+                    size_t skip = offset + needed > RING_CAPACITY ? RING_CAPACITY - offset : 0;
+
+                    size_t used = write - read_pos_.load(std::memory_order_acquire);
+                    while (RING_CAPACITY - used < skip + needed) {
+                        wake_writer();
+                        std::this_thread::yield();
+                        used = write - read_pos_.load(std::memory_order_acquire);
+                    }
+
+                    if (skip != 0) {
+                        std::memcpy(data_.get() + offset, &WRAP_MARKER, sizeof(WRAP_MARKER));
+                        write += skip;
+                        offset = 0;
+                    }
+                    std::memcpy(data_.get() + offset, &size, sizeof(size));
+                    std::memcpy(data_.get() + offset + sizeof(size), record, size);
+                    write_pos_.store(write + needed, std::memory_order_release);
+
+                    // Get the writer going before the ring fills up
+                    if (used < RING_CAPACITY / 2 && used + skip + needed >= RING_CAPACITY / 2) {
+                        wake_writer();
+                    }
+                }
+
+                // Consumer side. Hands every complete record to take_record, then frees
+                // their space. Returns whether there were any
+                template<typename TakeRecord>
+                bool pop_all(TakeRecord take_record) {
+                    size_t read = read_pos_.load(std::memory_order_relaxed);
+                    size_t write = write_pos_.load(std::memory_order_acquire);
+                    if (read == write) {
+                        return false;
+                    }
+
+                    while (read != write) {
+                        size_t offset = read & (RING_CAPACITY - 1);
+                        uint32_t size;
+                        std::memcpy(&size, data_.get() + offset, sizeof(size));
+                        if (size == WRAP_MARKER) {
+                            read += RING_CAPACITY - offset;
+                            continue;
+                        }
+                        take_record(data_.get() + offset + sizeof(size), size);
+                        read += align_record(sizeof(size) + size);
+                    }
+                    read_pos_.store(read, std::memory_order_release);
+                    return true;
+                }
+
+                ThreadLogBuffer* next_;
+
+            private:
+                std::unique_ptr<char[]> data_;
+                alignas(64) std::atomic<size_t> write_pos_;
+                alignas(64) std::atomic<size_t> read_pos_;
+        };
+
+        // Owns every thread's ring and the background thread that formats their
+        // records and writes them out in large batches
+        class AsyncWriter {
+            public:
+                AsyncWriter() : buffers_(nullptr), stop_(false), wake_requested_(false) {}
+
+                ~AsyncWriter() {
+                    if (thread_.joinable()) {
+                        {
+                            std::lock_guard<std::mutex> lock(wake_mutex_);
+                            stop_ = true;
+                        }
+                        wake_.notify_one();
+                        thread_.join();
+                    }
+                    drain_all();
+
+                    ThreadLogBuffer* buffer = buffers_.load();
+                    while (buffer != nullptr) {
+                        ThreadLogBuffer* next = buffer->next_;
+                        delete buffer;
+                        buffer = next;
+                    }
+                }
+
+                // Gives a thread its ring. Rings live until the program exits, so
+                // whatever a finished thread logged still gets written
+                ThreadLogBuffer* register_thread() {
+                    ThreadLogBuffer* buffer = new ThreadLogBuffer();
+                    buffer->next_ = buffers_.load(std::memory_order_acquire);
+                    while (!buffers_.compare_exchange_weak(buffer->next_, buffer, std::memory_order_release, std::memory_order_acquire)) {
+                    }
+                    std::call_once(start_flag_, [this] { thread_ = std::thread(&AsyncWriter::run, this); });
+                    return buffer;
+                }
+
+                void wake() {
+                    {
+                        std::lock_guard<std::mutex> lock(wake_mutex_);
+                        wake_requested_ = true;
+                    }
+                    wake_.notify_one();
+                }
+
+                // Writes out every record queued so far, on the calling thread
+                bool drain_all() {
+                    std::lock_guard<std::mutex> lock(drain_mutex_);
+                    return drain();
+                }
+
+                // Writes a record too big for the ring straight out, after everything before it
+                void write_direct(const char* record, size_t size) {
+                    std::lock_guard<std::mutex> lock(drain_mutex_);
+                    drain();
+                    batch_.clear();
+                    formatter_.append_line(batch_, record, size);
+                    write_to_destination(batch_);
+                }
+
+                void format_prefix(std::string& out, const char* record) {
+                    std::lock_guard<std::mutex> lock(drain_mutex_);
+                    RecordHeader header;
+                    std::memcpy(&header, record, sizeof(header));
+                    formatter_.append_prefix(out, header, std::string_view(record + sizeof(header), header.id_length));
+                }
+
+            private:
+                void run() {
+                    while (true) {
+                        bool drained = drain_all();
+
+                        std::unique_lock<std::mutex> lock(wake_mutex_);
+                        if (stop_) {
+                            break;
+                        }
+                        if (!drained) {
+                            wake_.wait_for(lock, WRITER_IDLE_WAIT, [this] { return stop_ || wake_requested_; });
+                        }
+                        wake_requested_ = false;
+                    }
+                }
+
+                // Caller holds drain_mutex_. Records from different threads are merged
+                // by timestamp, each thread's own records stay in order
+                bool drain() {
+                    batch_.clear();
+                    lines_.clear();
+                    int sources = 0;
+
+                    for (ThreadLogBuffer* buffer = buffers_.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next_) {
+                        bool popped = buffer->pop_all([this](const char* record, size_t size) {
+                            RecordHeader header;
+                            std::memcpy(&header, record, sizeof(header));
+                            size_t begin = batch_.size();
+                            formatter_.append_line(batch_, record, size);
+                            lines_.push_back({header.timestamp_ns, begin, batch_.size()});
+                        });
+                        sources += popped;
+                    }
+
+                    if (lines_.empty()) {
+                        return false;
+                    }
+
+                    if (sources == 1) {
+                        write_to_destination(batch_);
+                    } else {
+                        std::stable_sort(lines_.begin(), lines_.end(), [](const Line& a, const Line& b) {
+                            return a.timestamp_ns < b.timestamp_ns;
+                        });
+                        merged_.clear();
+                        for (const Line& line : lines_) {
+                            merged_.append(batch_, line.begin, line.end - line.begin);
+                        }
+                        write_to_destination(merged_);
+                    }
+                    return true;
+                }
+
+                struct Line {
+                    int64_t timestamp_ns;
+                    size_t begin;
+                    size_t end;
+                };
+
+                std::atomic<ThreadLogBuffer*> buffers_;
+
+                std::thread thread_;
+                std::once_flag start_flag_;
+                std::mutex wake_mutex_;
+                std::condition_variable wake_;
+                bool stop_;
+                bool wake_requested_;
+
+                // Everything below is only touched with drain_mutex_ held
+                std::mutex drain_mutex_;
+                RecordFormatter formatter_;
+                std::string batch_;
+                std::string merged_;
+                std::vector<Line> lines_;
+        };
+
+        // Defined after the file stream, so it is destroyed first and can still
+        // write the last records out at exit
+        AsyncWriter g_writer;
+
+        thread_local ThreadLogBuffer* t_buffer = nullptr;
+
+        // Metrics of one kind, in the order they were first used. Entries are
+        // never removed, so the references handed out stay valid until exit
+        template<typename Metric>
+        class MetricRegistry {
+            public:
+                Metric& get(std::string_view name) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (Entry& entry : entries_) {
+                        if (entry.name == name) {
+                            return *entry.metric;
+                        }
+                    }
+                    entries_.push_back({std::string(name), std::make_unique<Metric>()});
+                    return *entries_.back().metric;
+                }
+
+                template<typename Visit>
+                void for_each(Visit visit) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (const Entry& entry : entries_) {
+                        visit(entry.name, *entry.metric);
+                    }
+                }
+
+                size_t name_width() {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    size_t width = 0;
+                    for (const Entry& entry : entries_) {
+                        width = std::max(width, entry.name.size());
+                    }
+                    return width;
+                }
+
+                bool empty() {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return entries_.empty();
+                }
+
+            private:
+                struct Entry {
+                    std::string name;
+                    std::unique_ptr<Metric> metric;
+                };
+
+                std::mutex mutex_;
+                std::vector<Entry> entries_;
+        };
+
+        MetricRegistry<Histogram> g_timers;
+        MetricRegistry<Counter> g_counters;
+        MetricRegistry<Histogram> g_histograms;
+
+        // Writes the report asked for with set_metrics_report at exit. Defined
+        // after the registries, so they are still alive then
+        class MetricsReporter {
+            public:
+                ~MetricsReporter() {
+                    if (!enabled_) {
+                        return;
+                    }
+                    // Keep the report after the last log line on stderr
+                    flush();
+                    if (file_path_.empty()) {
+                        write_metrics_report(std::cerr, format_);
+                        return;
+                    }
+                    std::ofstream out(file_path_, std::ofstream::out | std::ofstream::trunc);
+                    if (!out.is_open()) {
+                        std::cerr << "[INTERNAL ERROR] Failed to open metrics file: " << file_path_ << std::endl;
+                        return;
+                    }
+                    write_metrics_report(out, format_);
+                }
+
+                void request(MetricsFormat format, const std::string& file_path) {
+                    enabled_ = true;
+                    format_ = format;
+                    file_path_ = file_path;
+                }
+
+            private:
+                bool enabled_ = false;
+                MetricsFormat format_ = MetricsFormat::TABLE;
+                std::string file_path_;
+        };
+
+        MetricsReporter g_metrics_reporter;
+
+        double mean(uint64_t sum, uint64_t count) {
+            return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+        }
+
+        void write_table(std::ostream& out) {
+            const double NS_PER_MS = 1e6;
+            int width = static_cast<int>(std::max({size_t(12), g_timers.name_width(), g_counters.name_width(), g_histograms.name_width()})) + 2;
+
+            out << "--- Instrumentation Metrics ---" << std::endl;
+            out << std::fixed << std::setprecision(3);
+            if (!g_timers.empty()) {
+                out << std::left << std::setw(width) << "Timer" << std::right << std::setw(12) << "Calls"
+                    << std::setw(14) << "Total ms" << std::setw(14) << "Mean ms" << std::setw(14) << "Min ms" << std::setw(14) << "Max ms" << std::endl;
+                g_timers.for_each([&](const std::string& name, const Histogram& timer) {
+                    out << std::left << std::setw(width) << name << std::right << std::setw(12) << timer.count()
+                        << std::setw(14) << timer.sum() / NS_PER_MS << std::setw(14) << mean(timer.sum(), timer.count()) / NS_PER_MS
+                        << std::setw(14) << timer.min() / NS_PER_MS << std::setw(14) << timer.max() / NS_PER_MS << std::endl;
+                });
+            }
+            if (!g_counters.empty()) {
+                out << std::left << std::setw(width) << "Counter" << std::right << std::setw(12) << "Value" << std::endl;
+                g_counters.for_each([&](const std::string& name, const Counter& counter) {
+                    out << std::left << std::setw(width) << name << std::right << std::setw(12) << counter.value() << std::endl;
+                });
+            }
+            if (!g_histograms.empty()) {
+                out << std::left << std::setw(width) << "Histogram" << std::right << std::setw(12) << "Count"
+                    << std::setw(14) << "Min" << std::setw(14) << "Mean" << std::setw(14) << "Max" << std::endl;
+                g_histograms.for_each([&](const std::string& name, const Histogram& histogram) {
+                    out << std::left << std::setw(width) << name << std::right << std::setw(12) << histogram.count()
+                        << std::setw(14) << histogram.min() << std::setw(14) << mean(histogram.sum(), histogram.count())
+                        << std::setw(14) << histogram.max() << std::endl;
+                });
+            }
+            out << std::defaultfloat;
+        }
+
+        void write_json_string(std::ostream& out, const std::string& text) {
+            out << '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out << '\\';
+                }
+                out << c;
+            }
+            out << '"';
+        }
+
+        void write_json(std::ostream& out) {
+            bool first = true;
+            out << "{" << std::endl << "  \"timers\": {";
+            g_timers.for_each([&](const std::string& name, const Histogram& timer) {
+                out << (first ? "" : ",") << std::endl << "    ";
+                write_json_string(out, name);
+                out << ": {\"calls\": " << timer.count() << ", \"total_ns\": " << timer.sum()
+                    << ", \"min_ns\": " << timer.min() << ", \"max_ns\": " << timer.max() << "}";
+                first = false;
+            });
+
+            first = true;
+            out << std::endl << "  }," << std::endl << "  \"counters\": {";
+            g_counters.for_each([&](const std::string& name, const Counter& counter) {
+                out << (first ? "" : ",") << std::endl << "    ";
+                write_json_string(out, name);
+                out << ": " << counter.value();
+                first = false;
+            });
+
+            first = true;
+            out << std::endl << "  }," << std::endl << "  \"histograms\": {";
+            g_histograms.for_each([&](const std::string& name, const Histogram& histogram) {
+                out << (first ? "" : ",") << std::endl << "    ";
+                write_json_string(out, name);
+                out << ": {\"count\": " << histogram.count() << ", \"sum\": " << histogram.sum()
+                    << ", \"min\": " << histogram.min() << ", \"max\": " << histogram.max() << ", \"buckets\": [";
+                // Only the buckets holding values, each with its largest value
+                bool first_bucket = true;
+                for (int bits = 0; bits < Histogram::NUM_BUCKETS; bits++) {
+                    if (histogram.bucket(bits) == 0) {
+                        continue;
+                    }
+                    uint64_t bucket_max = bits == 64 ? UINT64_MAX : (uint64_t(1) << bits) - 1;
+                    out << (first_bucket ? "" : ", ") << "{\"max\": " << bucket_max << ", \"count\": " << histogram.bucket(bits) << "}";
+                    first_bucket = false;
+                }
+                out << "]}";
+                first = false;
+            });
+            out << std::endl << "  }" << std::endl << "}" << std::endl;
+        }
+
+    } // namespace
+
+    // --- File Logging Control ---
     void set_log_file(const std::string& file_path) {
+        // Anything queued belongs to the old destination
+        flush();
         std::lock_guard<std::mutex> lock(g_log_mutex);
         if (g_log_file_stream.is_open()) {
             g_log_file_stream.close();
@@ -38,6 +585,7 @@ namespace Instrumentation {
     }
 
     void enable_file_logging(bool enable) {
+        flush();
         std::lock_guard<std::mutex> lock(g_log_mutex);
         if (enable && !g_file_logging_enabled) {
              // Try to open only if a path is set and not already enabled
@@ -65,6 +613,35 @@ namespace Instrumentation {
     }
     // --- End File Logging Control ---
 
+    void flush() {
+        g_writer.drain_all();
+    }
+
+    // --- Metrics ---
+    void set_metrics_report(MetricsFormat format, const std::string& file_path) {
+        g_metrics_reporter.request(format, file_path);
+    }
+
+    void write_metrics_report(std::ostream& out, MetricsFormat format) {
+        if (format == MetricsFormat::JSON) {
+            write_json(out);
+        } else {
+            write_table(out);
+        }
+    }
+
+    Counter& get_counter(std::string_view name) {
+        return g_counters.get(name);
+    }
+
+    Histogram& get_histogram(std::string_view name) {
+        return g_histograms.get(name);
+    }
+
+    Histogram& get_timer(std::string_view name) {
+        return g_timers.get(name);
+    }
+
     // Configuration functions implementation
     void set_max_severity(Severity max_severity) {
         g_max_severity = max_severity;
@@ -85,54 +662,70 @@ namespace Instrumentation {
 
     // Internal logging function implementation
     void log_message(Severity severity, const std::string& id, const std::string& message) {
-        // Severity check already done in macro, but double-check doesn't hurt
-        // Although, the primary check is in the macro to avoid formatting cost.
-        // if (severity < g_max_severity) {
-        //     return;
-        // }
+        log_record(severity, id, message);
+    }
 
-        std::lock_guard<std::mutex> lock(g_log_mutex);
+    namespace detail {
 
-        // Get current time
-        auto now = std::chrono::system_clock::now();
-        auto now_c = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-
-        // Format severity
-        std::string severity_str;
-        switch (severity) {
-            case Severity::TRACE:   severity_str = "TRACE";   break;
-            case Severity::INFO:    severity_str = "INFO";    break;
-            case Severity::WARNING: severity_str = "WARNING"; g_warning_count++; break;
-            case Severity::ERROR:   severity_str = "ERROR";   g_error_count++;   break;
-            case Severity::FATAL:   severity_str = "FATAL"; g_error_count++; break;
+        RecordEncoder& thread_encoder() {
+            thread_local RecordEncoder encoder;
+            return encoder;
         }
 
-        // Format the log message prefix
-        std::ostringstream log_prefix_ss;
-        log_prefix_ss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S")
-                      << '.' << std::setfill('0') << std::setw(3) << ms.count()
-                      << " [" << severity_str << "] [" << id << "] ";
-        
-        // Write to file or stderr
-        if (g_file_logging_enabled && g_log_file_stream.is_open()) {
-            g_log_file_stream << log_prefix_ss.str() << message << std::endl;
-        } else {
-            // Fallback to stderr if file logging is disabled or file not open
-            std::cerr << log_prefix_ss.str() << message << std::endl;
+        void RecordEncoder::begin(Severity severity, std::string_view id) {
+            auto now = std::chrono::system_clock::now();
+
+            RecordHeader header;
+            std::memset(&header, 0, sizeof(header));
+            header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+            header.id_length = static_cast<uint16_t>(std::min<size_t>(id.size(), UINT16_MAX));
+            header.severity = static_cast<uint8_t>(severity);
+
+            severity_ = severity;
+            record_.clear();
+            put_raw(header);
+            record_.append(id.data(), header.id_length);
         }
 
-        // Handle FATAL severity
-        if (severity == Severity::FATAL) {
-            const std::string fatal_msg = "FATAL error encountered. Exiting.";
-            if (g_file_logging_enabled && g_log_file_stream.is_open()) {
-                g_log_file_stream << log_prefix_ss.str() << fatal_msg << std::endl;
-                g_log_file_stream.flush(); // Ensure message is written
-                g_log_file_stream.close(); 
+        void RecordEncoder::commit() {
+            switch (severity_) {
+                case Severity::WARNING: g_warning_count++; break;
+                case Severity::ERROR:   g_error_count++;   break;
+                case Severity::FATAL:   g_error_count++;   break;
+                default: break;
+            }
+
+            if (record_.size() > RING_CAPACITY / 2) {
+                g_writer.write_direct(record_.data(), record_.size());
+            } else {
+                if (t_buffer == nullptr) {
+                    t_buffer = g_writer.register_thread();
+                }
+                t_buffer->push(record_.data(), static_cast<uint32_t>(record_.size()), [] { g_writer.wake(); });
+            }
+
+            // Handle FATAL severity: everything logged so far goes out before exiting
+            if (severity_ == Severity::FATAL) {
+                flush();
+
+                std::string log_prefix;
+                g_writer.format_prefix(log_prefix, record_.data());
+                const std::string fatal_msg = "FATAL error encountered. Exiting.";
+
+                {
+                    // released before exiting, the writer still takes it while shutting down
+                    std::lock_guard<std::mutex> lock(g_log_mutex);
+                    if (g_file_logging_enabled && g_log_file_stream.is_open()) {
+                        g_log_file_stream << log_prefix << fatal_msg << std::endl;
+                        g_log_file_stream.flush(); // Ensure message is written
+                        g_log_file_stream.close();
+                    }
+                    std::cerr << log_prefix << fatal_msg << std::endl; // Always print FATAL to stderr too
+                }
+                std::exit(EXIT_FAILURE); // Use EXIT_FAILURE from <cstdlib>
             }
-             std::cerr << log_prefix_ss.str() << fatal_msg << std::endl; // Always print FATAL to stderr too
-            std::exit(EXIT_FAILURE); // Use EXIT_FAILURE from <cstdlib>
         }
-    }
 
-} // namespace Instrumentation 
\ No newline at end of file
+    } // namespace detail
+
+} // namespace Instrumentation
@@ -82,6 +82,8 @@ void printUsage(const char* prog_name) {
     std::cerr << "  -log <filename>      Enable logging to the specified file (default: disabled)" << std::endl;
     std::cerr << "  -loglevel <level>    Set the logging severity level (default: INFO)" << std::endl;
     std::cerr << "                       Levels: TRACE, INFO, WARNING, ERROR, FATAL" << std::endl;
+    std::cerr << "  -metrics             Print phase timers and counters to stderr at exit" << std::endl;
+    std::cerr << "  -metrics_json <file> Write phase timers and counters as JSON at exit" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -115,6 +117,10 @@ int main(int argc, char* argv[]) {
                 // Don't call INST_FATAL here as logging might not be fully set.
             }
              // severity_set = true;
+        } else if (arg == "-metrics") {
+            Instrumentation::set_metrics_report(MetricsFormat::TABLE, "");
+        } else if (arg == "-metrics_json" && i + 1 < argc) {
+            Instrumentation::set_metrics_report(MetricsFormat::JSON, argv[++i]); // Consume next argument as filename
         } else if (libraryFile.empty()) {
             // Assume the first non-flag argument is the library file
             libraryFile = arg;
@@ -223,6 +229,7 @@ int main(int argc, char* argv[]) {
 }
 
 void runForwardTraversal(Circuit &circuit) {
+    INST_SCOPE("FWD_TRAVERSAL");
     INST_TRACE("ForwardTraversal", "Starting forward traversal.");
     circuit.totalCircuitDelay = 0;
     queue <CircuitNode*> nodeQueue;
@@ -284,6 +291,8 @@ void runForwardTraversal(Circuit &circuit) {
 
     INST_TRACE("ForwardTraversal", "Starting main traversal loop.");
     while (!nodeQueue.empty()) {
+        INST_HISTOGRAM("FWD_QUEUE_DEPTH", nodeQueue.size());
+        INST_COUNT("FWD_NODES_VISITED", 1);
         CircuitNode* operatingNode = nodeQueue.front();
         nodeQueue.pop();
         INST_TRACE("ForwardTraversal", "Processing node:", operatingNode->gate_type_);
@@ -375,19 +384,23 @@ void runForwardTraversal(Circuit &circuit) {
 }
 
 void findNodeOutputValues(Circuit &circuit, CircuitNode &circuitNode) {
-    ostringstream oss;
-    oss << std::fixed << std::setprecision(5);
-    oss.str("");
-    oss << "Calculating output values for node: " << circuitNode.gate_type_;
-    INST_TRACE("FindOutputValues", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Calculating output values for node: " << circuitNode.gate_type_;
+        INST_TRACE("FindOutputValues", oss.str());
+    }
 
     double loadCap = circuitNode.outputLoad;
     unsigned int numInputs = circuitNode.inputArrivalTimes.size();
     double multiplier = 1;
 
-    oss.str("");
-    oss << "Node: " << circuitNode.gate_type_ << ", Load Cap: " << loadCap << ", Num Inputs: " << numInputs;
-    INST_TRACE("FindOutputValues", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Node: " << circuitNode.gate_type_ << ", Load Cap: " << loadCap << ", Num Inputs: " << numInputs;
+        INST_TRACE("FindOutputValues", oss.str());
+    }
 
     if (numInputs > 2) {
         multiplier = numInputs / 2.0;
@@ -419,10 +432,13 @@ void findNodeOutputValues(Circuit &circuit, CircuitNode &circuitNode) {
         circuitNode.gateDelays.push_back(tempDelay);
         circuitNode.outputArrivalTimes.push_back(tempTimeOut);
 
-        oss.str(""); oss.clear();
-        oss << "Input " << i << ": InputSlew=" << circuitNode.inputSlews[i] << ", InputArrival=" << circuitNode.inputArrivalTimes[i]
-                     << " -> Calculated SlewOut=" << tempSlewOut << ", Calculated Delay=" << tempDelay << ", Calculated Arrival=" << tempTimeOut;
-        INST_TRACE("FindOutputValues", oss.str());
+        if (INST_TRACE_ENABLED()) {
+            ostringstream oss;
+            oss << std::fixed << std::setprecision(5);
+            oss << "Input " << i << ": InputSlew=" << circuitNode.inputSlews[i] << ", InputArrival=" << circuitNode.inputArrivalTimes[i]
+                 << " -> Calculated SlewOut=" << tempSlewOut << ", Calculated Delay=" << tempDelay << ", Calculated Arrival=" << tempTimeOut;
+            INST_TRACE("FindOutputValues", oss.str());
+        }
 
         if (tempTimeOut > maxTimeOut) {
             INST_TRACE("FindOutputValues", "New max arrival time found:", tempTimeOut, "(was", maxTimeOut, "). Corresponding Slew:", tempSlewOut);
@@ -442,16 +458,18 @@ void findNodeOutputValues(Circuit &circuit, CircuitNode &circuitNode) {
         circuitNode.outputArrivalTimes[i] *= multiplier;
     }
 
-    oss.str(""); oss.clear();
-    oss << "Final calculated values for " << circuitNode.gate_type_ << ": timeOut=" << circuitNode.timeOut << ", slewOut=" << circuitNode.slewOut << ", cellDelay=" << circuitNode.cellDelay;
-    INST_TRACE("FindOutputValues", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Final calculated values for " << circuitNode.gate_type_ << ": timeOut=" << circuitNode.timeOut << ", slewOut=" << circuitNode.slewOut << ", cellDelay=" << circuitNode.cellDelay;
+        INST_TRACE("FindOutputValues", oss.str());
+    }
 }
 
 void runBackwardTraversal (Circuit &circuit) {
+    INST_SCOPE("BWD_TRAVERSAL");
     INST_TRACE("BackwardTraversal", "Starting backward traversal.");
     queue <CircuitNode*> nodeQueue;
-    // Declare oss here for use within the function scope
-    ostringstream oss;
 
     INST_TRACE("BackwardTraversal", "Resetting required times and slacks for all nodes.");
     for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
@@ -474,12 +492,13 @@ void runBackwardTraversal (Circuit &circuit) {
                 circuit.nodes_[nodeNum]->requiredArrivalTime = requiredTimePO;
                 circuit.nodes_[nodeNum]->gateSlack = circuit.nodes_[nodeNum]->requiredArrivalTime - circuit.nodes_[nodeNum]->timeOut;
 
-                // Clear and reuse oss
-                oss.str(""); oss.clear();
-                oss << std::fixed << std::setprecision(5);
-                oss << "PO " << circuit.nodes_[nodeNum]->gate_type_ << ": Set requiredArrivalTime=" << circuit.nodes_[nodeNum]->requiredArrivalTime
-                     << ", calculated gateSlack=" << circuit.nodes_[nodeNum]->gateSlack << " (timeOut=" << circuit.nodes_[nodeNum]->timeOut << ")";
-                INST_TRACE("BackwardTraversal", oss.str());
+                if (INST_TRACE_ENABLED()) {
+                    ostringstream oss;
+                    oss << std::fixed << std::setprecision(5);
+                    oss << "PO " << circuit.nodes_[nodeNum]->gate_type_ << ": Set requiredArrivalTime=" << circuit.nodes_[nodeNum]->requiredArrivalTime
+                         << ", calculated gateSlack=" << circuit.nodes_[nodeNum]->gateSlack << " (timeOut=" << circuit.nodes_[nodeNum]->timeOut << ")";
+                    INST_TRACE("BackwardTraversal", oss.str());
+                }
 
                 for (unsigned int inputNodeNum = 0; inputNodeNum < circuit.nodes_[nodeNum]->fanin_list_.size(); inputNodeNum++) {
                     unsigned int tempNodeNum = circuit.nodes_[nodeNum]->fanin_list_[inputNodeNum];
@@ -500,6 +519,8 @@ void runBackwardTraversal (Circuit &circuit) {
 
     INST_TRACE("BackwardTraversal", "Starting main traversal loop.");
     while (!nodeQueue.empty()) {
+        INST_HISTOGRAM("BWD_QUEUE_DEPTH", nodeQueue.size());
+        INST_COUNT("BWD_NODES_VISITED", 1);
         CircuitNode* operatingNode = nodeQueue.front();
         nodeQueue.pop();
         INST_TRACE("BackwardTraversal", "Processing node:", operatingNode->gate_type_);
@@ -534,13 +555,14 @@ void runBackwardTraversal (Circuit &circuit) {
 
             double requiredTimeThruPath = fanoutNode->requiredArrivalTime - delayOfFanoutGateForThisInput;
 
-            // Clear and reuse oss inside the loop
-            oss.str(""); oss.clear();
-            oss << std::fixed << std::setprecision(5);
-            oss << "Fanout " << fanoutNode->gate_type_ << ": requiredArrivalTime=" << fanoutNode->requiredArrivalTime
-                << ", delayOnInputFrom(" << operatingNode->gate_type_ << ")=" << delayOfFanoutGateForThisInput
-                << " -> requiredTimeThruPath=" << requiredTimeThruPath;
-            INST_TRACE("BackwardTraversal", oss.str());
+            if (INST_TRACE_ENABLED()) {
+                ostringstream oss;
+                oss << std::fixed << std::setprecision(5);
+                oss << "Fanout " << fanoutNode->gate_type_ << ": requiredArrivalTime=" << fanoutNode->requiredArrivalTime
+                     << ", delayOnInputFrom(" << operatingNode->gate_type_ << ")=" << delayOfFanoutGateForThisInput
+                     << " -> requiredTimeThruPath=" << requiredTimeThruPath;
+                INST_TRACE("BackwardTraversal", oss.str());
+            }
 
             if (requiredTimeThruPath < minRequiredTime) {
                 minRequiredTime = requiredTimeThruPath;
@@ -556,12 +578,13 @@ void runBackwardTraversal (Circuit &circuit) {
         operatingNode->requiredArrivalTime = minRequiredTime;
         operatingNode->gateSlack = operatingNode->requiredArrivalTime - operatingNode->timeOut;
 
-        // Clear and reuse oss
-        oss.str(""); oss.clear();
-        oss << std::fixed << std::setprecision(5);
-        oss << "Node " << operatingNode->gate_type_ << ": Set requiredArrivalTime=" << operatingNode->requiredArrivalTime
-             << ", calculated gateSlack=" << operatingNode->gateSlack << " (timeOut=" << operatingNode->timeOut << ")";
-        INST_TRACE("BackwardTraversal", oss.str());
+        if (INST_TRACE_ENABLED()) {
+            ostringstream oss;
+            oss << std::fixed << std::setprecision(5);
+            oss << "Node " << operatingNode->gate_type_ << ": Set requiredArrivalTime=" << operatingNode->requiredArrivalTime
+                 << ", calculated gateSlack=" << operatingNode->gateSlack << " (timeOut=" << operatingNode->timeOut << ")";
+            INST_TRACE("BackwardTraversal", oss.str());
+        }
 
         INST_TRACE("BackwardTraversal", "Processing fanins of node:", operatingNode->gate_type_);
         for (unsigned int inputNodeNum = 0; inputNodeNum < operatingNode->fanin_list_.size(); inputNodeNum++) {
@@ -582,24 +605,22 @@ void runBackwardTraversal (Circuit &circuit) {
 }
 
 vector <CircuitNode*> findCriticalPath (Circuit &circuit) {
+    INST_SCOPE("CRITICAL_PATH");
     INST_TRACE("FindCriticalPath", "Starting critical path search.");
     vector <CircuitNode*> criticalPath;
     CircuitNode* curr = NULL;
     double minSlack = std::numeric_limits<double>::max();
-    // Declare oss streams needed in this function
-    ostringstream oss;
-    ostringstream oss_curr;
-    ostringstream oss_fanin;
 
     INST_TRACE("FindCriticalPath", "Finding PO with minimum slack.");
     for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
         if (circuit.nodes_[nodeNum] != NULL) {
             if (circuit.nodes_[nodeNum]->output_pad_) {
-                // Clear and reuse oss
-                oss.str(""); oss.clear();
-                oss << std::fixed << std::setprecision(5);
-                oss << "Checking PO " << circuit.nodes_[nodeNum]->gate_type_ << " (NodeID " << circuit.nodes_[nodeNum]->node_id_ << ") with slack " << circuit.nodes_[nodeNum]->gateSlack;
-                INST_TRACE("FindCriticalPath", oss.str());
+                if (INST_TRACE_ENABLED()) {
+                    ostringstream oss;
+                    oss << std::fixed << std::setprecision(5);
+                    oss << "Checking PO " << circuit.nodes_[nodeNum]->gate_type_ << " (NodeID " << circuit.nodes_[nodeNum]->node_id_ << ") with slack " << circuit.nodes_[nodeNum]->gateSlack;
+                    INST_TRACE("FindCriticalPath", oss.str());
+                }
 
                 if (circuit.nodes_[nodeNum]->gateSlack < minSlack - 1e-9) {
                     minSlack = circuit.nodes_[nodeNum]->gateSlack;
@@ -627,11 +648,12 @@ vector <CircuitNode*> findCriticalPath (Circuit &circuit) {
         CircuitNode* nextNode = NULL;
         double current_min_slack = std::numeric_limits<double>::max();
 
-        // Clear and reuse oss_curr
-        oss_curr.str(""); oss_curr.clear();
-        oss_curr << std::fixed << std::setprecision(5);
-        oss_curr << "Current node: " << curr->gate_type_ << " (NodeID " << curr->node_id_ << ", Slack: " << curr->gateSlack << "). Looking at fanins.";
-        INST_TRACE("FindCriticalPath", oss_curr.str());
+        if (INST_TRACE_ENABLED()) {
+            ostringstream oss;
+            oss << std::fixed << std::setprecision(5);
+            oss << "Current node: " << curr->gate_type_ << " (NodeID " << curr->node_id_ << ", Slack: " << curr->gateSlack << "). Looking at fanins.";
+            INST_TRACE("FindCriticalPath", oss.str());
+        }
 
         for (unsigned int inputNodeNum = 0; inputNodeNum < curr->fanin_list_.size(); inputNodeNum++) {
             unsigned int tempNodeNum = curr->fanin_list_[inputNodeNum];
@@ -641,11 +663,12 @@ vector <CircuitNode*> findCriticalPath (Circuit &circuit) {
             }
             CircuitNode* faninNode = circuit.nodes_[tempNodeNum];
 
-            // Clear and reuse oss_fanin
-            oss_fanin.str(""); oss_fanin.clear();
-            oss_fanin << std::fixed << std::setprecision(5);
-            oss_fanin << "  Checking fanin: " << faninNode->gate_type_ << " (NodeID " << faninNode->node_id_ << ", Slack: " << faninNode->gateSlack << ")";
-            INST_TRACE("FindCriticalPath", oss_fanin.str());
+            if (INST_TRACE_ENABLED()) {
+                ostringstream oss;
+                oss << std::fixed << std::setprecision(5);
+                oss << "  Checking fanin: " << faninNode->gate_type_ << " (NodeID " << faninNode->node_id_ << ", Slack: " << faninNode->gateSlack << ")";
+                INST_TRACE("FindCriticalPath", oss.str());
+            }
 
             if (faninNode->gateSlack < current_min_slack - 1e-9) {
                 current_min_slack = faninNode->gateSlack;
@@ -691,6 +714,7 @@ vector <CircuitNode*> findCriticalPath (Circuit &circuit) {
 }
 
 void outputCircuitTraversal (Circuit &circuit, vector <CircuitNode*> &criticalPath, string outputFile, bool printToTerminal, bool printToFile) {
+    INST_SCOPE("OUTPUT");
     INST_TRACE("Output", "Starting output generation.");
     ofstream fileOut;
     if (printToFile) { 
@@ -757,6 +781,7 @@ void outputCircuitTraversal (Circuit &circuit, vector <CircuitNode*> &criticalPa
 }
 
 void convertDFFs(Circuit &circuit) {
+    INST_SCOPE("CONVERT_DFFS");
     INST_TRACE("ConvertDFFs", "Starting DFF conversion.");
     for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
         if (circuit.nodes_[nodeNum] != NULL) {
@@ -772,6 +797,7 @@ void convertDFFs(Circuit &circuit) {
 }
 
 void createFanOutLists(Circuit &circuit) {
+    INST_SCOPE("CREATE_FANOUT_LISTS");
     INST_TRACE("CreateFanout", "Starting fanout list creation and degree calculation.");
     for (unsigned int nodeNum = 0; nodeNum < circuit.nodes_.size(); nodeNum++) {
         if (circuit.nodes_[nodeNum] != NULL) {
@@ -800,10 +826,13 @@ void createFanOutLists(Circuit &circuit) {
 }
 
 double calculateOutputSlew(Circuit &circuit, string gateType, double inputSlew, double loadCapacitance) {
-    ostringstream oss;
-    oss << std::fixed << std::setprecision(5);
-    oss << "Calculating Output Slew for Gate Type: " << gateType << ", Input Slew: " << inputSlew << ", Load Cap: " << loadCapacitance;
-    INST_TRACE("CalcOutputSlew", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Calculating Output Slew for Gate Type: " << gateType << ", Input Slew: " << inputSlew << ", Load Cap: " << loadCapacitance;
+        INST_TRACE("CalcOutputSlew", oss.str());
+    }
+    INST_COUNT("LUT_LOOKUPS", 1);
 
     auto it = circuit.gate_db_.gate_info_lut_.find(gateType);
     if (it == circuit.gate_db_.gate_info_lut_.end() || it->second == nullptr) {
@@ -831,12 +860,14 @@ double calculateOutputSlew(Circuit &circuit, string gateType, double inputSlew,
     if (slewIndex == -1) {
         if (inputSlew < gateInfo->output_slewindex1[0]) {
             INST_WARNING("CalcOutputSlew", "Input slew", inputSlew, "is below table minimum", gateInfo->output_slewindex1[0], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             T1 = gateInfo->output_slewindex1[0];
             T2 = gateInfo->output_slewindex1[1];
             slewIndex = 0;
             inputSlew = T1;
         } else if (inputSlew > gateInfo->output_slewindex1[GATE_LUT_DIM-1]) {
             INST_WARNING("CalcOutputSlew", "Input slew", inputSlew, "is above table maximum", gateInfo->output_slewindex1[GATE_LUT_DIM-1], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             T1 = gateInfo->output_slewindex1[GATE_LUT_DIM-2];
             T2 = gateInfo->output_slewindex1[GATE_LUT_DIM-1];
             slewIndex = GATE_LUT_DIM - 2;
@@ -860,12 +891,14 @@ double calculateOutputSlew(Circuit &circuit, string gateType, double inputSlew,
     if (capacitanceIndex == -1) {
         if (loadCapacitance < gateInfo->output_slewindex2[0]) {
             INST_WARNING("CalcOutputSlew", "Load capacitance", loadCapacitance, "is below table minimum", gateInfo->output_slewindex2[0], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             C1 = gateInfo->output_slewindex2[0];
             C2 = gateInfo->output_slewindex2[1];
             capacitanceIndex = 0;
             loadCapacitance = C1;
         } else if (loadCapacitance > gateInfo->output_slewindex2[GATE_LUT_DIM-1]) {
             INST_WARNING("CalcOutputSlew", "Load capacitance", loadCapacitance, "is above table maximum", gateInfo->output_slewindex2[GATE_LUT_DIM-1], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             C1 = gateInfo->output_slewindex2[GATE_LUT_DIM-2];
             C2 = gateInfo->output_slewindex2[GATE_LUT_DIM-1];
             capacitanceIndex = GATE_LUT_DIM - 2;
@@ -907,24 +940,30 @@ double calculateOutputSlew(Circuit &circuit, string gateType, double inputSlew,
                      + V22 * (loadCapacitance - C1) * (inputSlew - T1) ) / denom;
     }
 
-    oss.str(""); oss.clear();
-    oss << "Interpolation Params: C1=" << C1 << ", C2=" << C2 << ", T1=" << T1 << ", T2=" << T2;
-    INST_TRACE("CalcOutputSlew", oss.str());
-    oss.str(""); oss.clear();
-    oss << "Interpolation Values: V11=" << V11 << ", V12=" << V12 << ", V21=" << V21 << ", V22=" << V22;
-    INST_TRACE("CalcOutputSlew", oss.str());
-    oss.str(""); oss.clear();
-    oss << "Calculated Output Slew: " << outputSlew;
-    INST_TRACE("CalcOutputSlew", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Interpolation Params: C1=" << C1 << ", C2=" << C2 << ", T1=" << T1 << ", T2=" << T2;
+        INST_TRACE("CalcOutputSlew", oss.str());
+        oss.str("");
+        oss << "Interpolation Values: V11=" << V11 << ", V12=" << V12 << ", V21=" << V21 << ", V22=" << V22;
+        INST_TRACE("CalcOutputSlew", oss.str());
+        oss.str("");
+        oss << "Calculated Output Slew: " << outputSlew;
+        INST_TRACE("CalcOutputSlew", oss.str());
+    }
 
     return outputSlew;
 }
 
 double calculateDelay(Circuit &circuit, string gateType, double inputSlew, double loadCapacitance) {
-    ostringstream oss;
-    oss << std::fixed << std::setprecision(5);
-    oss << "Calculating Delay for Gate Type: " << gateType << ", Input Slew: " << inputSlew << ", Load Cap: " << loadCapacitance;
-    INST_TRACE("CalcDelay", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Calculating Delay for Gate Type: " << gateType << ", Input Slew: " << inputSlew << ", Load Cap: " << loadCapacitance;
+        INST_TRACE("CalcDelay", oss.str());
+    }
+    INST_COUNT("LUT_LOOKUPS", 1);
 
     auto it = circuit.gate_db_.gate_info_lut_.find(gateType);
     if (it == circuit.gate_db_.gate_info_lut_.end() || it->second == nullptr) {
@@ -952,12 +991,14 @@ double calculateDelay(Circuit &circuit, string gateType, double inputSlew, doubl
     if (slewIndex == -1) {
         if (inputSlew < gateInfo->cell_delayindex1[0]) {
             INST_WARNING("CalcDelay", "Input slew", inputSlew, "is below table minimum", gateInfo->cell_delayindex1[0], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             T1 = gateInfo->cell_delayindex1[0];
             T2 = gateInfo->cell_delayindex1[1];
             slewIndex = 0;
             inputSlew = T1;
         } else if (inputSlew > gateInfo->cell_delayindex1[GATE_LUT_DIM-1]) {
             INST_WARNING("CalcDelay", "Input slew", inputSlew, "is above table maximum", gateInfo->cell_delayindex1[GATE_LUT_DIM-1], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             T1 = gateInfo->cell_delayindex1[GATE_LUT_DIM-2];
             T2 = gateInfo->cell_delayindex1[GATE_LUT_DIM-1];
             slewIndex = GATE_LUT_DIM - 2;
@@ -981,12 +1022,14 @@ double calculateDelay(Circuit &circuit, string gateType, double inputSlew, doubl
     if (capacitanceIndex == -1) {
         if (loadCapacitance < gateInfo->cell_delayindex2[0]) {
             INST_WARNING("CalcDelay", "Load capacitance", loadCapacitance, "is below table minimum", gateInfo->cell_delayindex2[0], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             C1 = gateInfo->cell_delayindex2[0];
             C2 = gateInfo->cell_delayindex2[1];
             capacitanceIndex = 0;
             loadCapacitance = C1;
         } else if (loadCapacitance > gateInfo->cell_delayindex2[GATE_LUT_DIM-1]) {
             INST_WARNING("CalcDelay", "Load capacitance", loadCapacitance, "is above table maximum", gateInfo->cell_delayindex2[GATE_LUT_DIM-1], "for gate", gateType, ". Clamping.");
+            INST_COUNT("LUT_CLAMPS", 1);
             C1 = gateInfo->cell_delayindex2[GATE_LUT_DIM-2];
             C2 = gateInfo->cell_delayindex2[GATE_LUT_DIM-1];
             capacitanceIndex = GATE_LUT_DIM - 2;
@@ -1028,15 +1071,18 @@ double calculateDelay(Circuit &circuit, string gateType, double inputSlew, doubl
                      + V22 * (loadCapacitance - C1) * (inputSlew - T1) ) / denom;
     }
 
-    oss.str(""); oss.clear();
-    oss << "Interpolation Params: C1=" << C1 << ", C2=" << C2 << ", T1=" << T1 << ", T2=" << T2;
-    INST_TRACE("CalcDelay", oss.str());
-    oss.str(""); oss.clear();
-    oss << "Interpolation Values: V11=" << V11 << ", V12=" << V12 << ", V21=" << V21 << ", V22=" << V22;
-    INST_TRACE("CalcDelay", oss.str());
-    oss.str(""); oss.clear();
-    oss << "Calculated Delay: " << outputDelay;
-    INST_TRACE("CalcDelay", oss.str());
+    if (INST_TRACE_ENABLED()) {
+        ostringstream oss;
+        oss << std::fixed << std::setprecision(5);
+        oss << "Interpolation Params: C1=" << C1 << ", C2=" << C2 << ", T1=" << T1 << ", T2=" << T2;
+        INST_TRACE("CalcDelay", oss.str());
+        oss.str("");
+        oss << "Interpolation Values: V11=" << V11 << ", V12=" << V12 << ", V21=" << V21 << ", V22=" << V22;
+        INST_TRACE("CalcDelay", oss.str());
+        oss.str("");
+        oss << "Calculated Delay: " << outputDelay;
+        INST_TRACE("CalcDelay", oss.str());
+    }
 
     return outputDelay;
 }